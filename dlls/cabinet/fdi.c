@@ -154,6 +154,9 @@ typedef struct fdi_cds_fwd {
   cab_ULONG q_position_base[42];
   cab_ULONG lzx_position_base[51];
   cab_UBYTE extra_bits[51];
+  /* MSZIP fixed Huffman tables, built on first use */
+  struct Ziphuft *zip_fixed_tl, *zip_fixed_td;
+  cab_LONG zip_fixed_bl, zip_fixed_bd;
   USHORT  setID;                   /* Cabinet set ID */
   USHORT  iCabinet;                /* Cabinet number in set (0 based) */
   struct fdi_cds_fwd *decomp_cab;
@@ -862,6 +865,20 @@ static int NONEfdi_decomp(int inlen, int outlen, fdi_decomp_state *decomp_state)
   return DECR_OK;
 }
 
+/********************************************************
+ * fdi_copy_match (internal)
+ *
+ * Copies a back-reference.  Overlapping source and destination must be
+ * copied byte by byte to replicate the repeated pattern.
+ */
+static inline void fdi_copy_match(cab_UBYTE *dest, const cab_UBYTE *src, cab_ULONG len)
+{
+  if (src + len <= dest || dest + len <= src)
+    memcpy(dest, src, len);
+  else
+    while (len--) *dest++ = *src++;
+}
+
 /********************************************************
  * Ziphuft_free (internal)
  */
@@ -1129,10 +1146,9 @@ static cab_LONG fdi_Zipinflate_codes(const struct Ziphuft *tl, const struct Ziph
         e = ZIPWSIZE - max(d, w);
         e = min(e, n);
         n -= e;
-        do
-        {
-          CAB(outbuf)[w++] = CAB(outbuf)[d++];
-        } while (--e);
+        fdi_copy_match(CAB(outbuf) + w, CAB(outbuf) + d, e);
+        w += e;
+        d += e;
       } while (n);
     }
   }
@@ -1175,13 +1191,19 @@ static cab_LONG fdi_Zipinflate_stored(fdi_decomp_state *decomp_state)
     return 1;                   /* error in compressed data */
   ZIPDUMPBITS(16)
 
-  /* read and output the compressed data */
-  while(n--)
+  if (w + n > ZIPWSIZE)
+    return 1;
+
+  /* drain whole bytes left in the bit buffer, then copy the rest directly */
+  while(n && k)
   {
-    ZIPNEEDBITS(8)
     CAB(outbuf)[w++] = (cab_UBYTE)b;
     ZIPDUMPBITS(8)
+    n--;
   }
+  memcpy(CAB(outbuf) + w, ZIP(inpos), n);
+  ZIP(inpos) += n;
+  w += n;
 
   /* restore the globals from the locals */
   ZIP(window_posn) = w;              /* restore global window pointer */
@@ -1195,43 +1217,50 @@ static cab_LONG fdi_Zipinflate_stored(fdi_decomp_state *decomp_state)
  */
 static cab_LONG fdi_Zipinflate_fixed(fdi_decomp_state *decomp_state)
 {
-  struct Ziphuft *fixed_tl;
-  struct Ziphuft *fixed_td;
-  cab_LONG fixed_bl, fixed_bd;
   cab_LONG i;                /* temporary variable */
   cab_ULONG *l;
 
-  l = ZIP(ll);
-
-  /* literal table */
-  for(i = 0; i < 144; i++)
-    l[i] = 8;
-  for(; i < 256; i++)
-    l[i] = 9;
-  for(; i < 280; i++)
-    l[i] = 7;
-  for(; i < 288; i++)          /* make a complete, but wrong code set */
-    l[i] = 8;
-  fixed_bl = 7;
-  if((i = fdi_Ziphuft_build(l, 288, 257, Zipcplens, Zipcplext, &fixed_tl, &fixed_bl, decomp_state)))
-    return i;
-
-  /* distance table */
-  for(i = 0; i < 30; i++)      /* make an incomplete code set */
-    l[i] = 5;
-  fixed_bd = 5;
-  if((i = fdi_Ziphuft_build(l, 30, 0, Zipcpdist, Zipcpdext, &fixed_td, &fixed_bd, decomp_state)) > 1)
+  /* the fixed tables never change, so only build them for the first fixed block */
+  if (!CAB(zip_fixed_tl))
   {
-    fdi_Ziphuft_free(CAB(fdi), fixed_tl);
-    return i;
+    struct Ziphuft *fixed_tl;
+    struct Ziphuft *fixed_td;
+    cab_LONG fixed_bl, fixed_bd;
+
+    l = ZIP(ll);
+
+    /* literal table */
+    for(i = 0; i < 144; i++)
+      l[i] = 8;
+    for(; i < 256; i++)
+      l[i] = 9;
+    for(; i < 280; i++)
+      l[i] = 7;
+    for(; i < 288; i++)          /* make a complete, but wrong code set */
+      l[i] = 8;
+    fixed_bl = 7;
+    if((i = fdi_Ziphuft_build(l, 288, 257, Zipcplens, Zipcplext, &fixed_tl, &fixed_bl, decomp_state)))
+      return i;
+
+    /* distance table */
+    for(i = 0; i < 30; i++)      /* make an incomplete code set */
+      l[i] = 5;
+    fixed_bd = 5;
+    if((i = fdi_Ziphuft_build(l, 30, 0, Zipcpdist, Zipcpdext, &fixed_td, &fixed_bd, decomp_state)) > 1)
+    {
+      fdi_Ziphuft_free(CAB(fdi), fixed_tl);
+      return i;
+    }
+
+    CAB(zip_fixed_tl) = fixed_tl;
+    CAB(zip_fixed_td) = fixed_td;
+    CAB(zip_fixed_bl) = fixed_bl;
+    CAB(zip_fixed_bd) = fixed_bd;
   }
 
   /* decompress until an end-of-block code */
-  i = fdi_Zipinflate_codes(fixed_tl, fixed_td, fixed_bl, fixed_bd, decomp_state);
-
-  fdi_Ziphuft_free(CAB(fdi), fixed_td);
-  fdi_Ziphuft_free(CAB(fdi), fixed_tl);
-  return i;
+  return fdi_Zipinflate_codes(CAB(zip_fixed_tl), CAB(zip_fixed_td), CAB(zip_fixed_bl),
+    CAB(zip_fixed_bd), decomp_state);
 }
 
 /**************************************************************
@@ -1773,14 +1802,15 @@ static int LZXfdi_decomp(int inlen, int outlen, fdi_decomp_state *decomp_state)
               if (copy_length < match_length) {
                 match_length -= copy_length;
                 window_posn += copy_length;
-                while (copy_length-- > 0) *rundest++ = *runsrc++;
+                fdi_copy_match(rundest, runsrc, copy_length);
+                rundest += copy_length;
                 runsrc = window;
               }
             }
             window_posn += match_length;
 
             /* copy match data - no worries about destination wraps */
-            while (match_length-- > 0) *rundest++ = *runsrc++;
+            fdi_copy_match(rundest, runsrc, match_length);
           }
         }
         break;
@@ -1862,14 +1892,15 @@ static int LZXfdi_decomp(int inlen, int outlen, fdi_decomp_state *decomp_state)
               if (copy_length < match_length) {
                 match_length -= copy_length;
                 window_posn += copy_length;
-                while (copy_length-- > 0) *rundest++ = *runsrc++;
+                fdi_copy_match(rundest, runsrc, copy_length);
+                rundest += copy_length;
                 runsrc = window;
               }
             }
             window_posn += match_length;
 
             /* copy match data - no worries about destination wraps */
-            while (match_length-- > 0) *rundest++ = *runsrc++;
+            fdi_copy_match(rundest, runsrc, match_length);
           }
         }
         break;
@@ -2250,6 +2281,9 @@ static void free_decompression_mem(FDI_Int *fdi, fdi_decomp_state *decomp_state)
       CAB(firstfile) = CAB(firstfile)->next;
       fdi->free(file);
     }
+    if (CAB(zip_fixed_tl)) fdi_Ziphuft_free(fdi, CAB(zip_fixed_tl));
+    if (CAB(zip_fixed_td)) fdi_Ziphuft_free(fdi, CAB(zip_fixed_td));
+
     prev_fds = decomp_state;
     decomp_state = CAB(next);
     fdi->free(prev_fds);
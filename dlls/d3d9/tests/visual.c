@@ -29,6 +29,7 @@
  */
 
 #define COBJMACROS
+#include <stdio.h>
 #include <d3d9.h>
 #include "wine/test.h"
 
@@ -16547,11 +16548,81 @@ done:
     DestroyWindow(window);
 }
 
+/* Run the whole test again in a child process with Wine's multithreaded
+ * command stream enabled through the per-application Direct3D settings. */
+static void test_csmt(const char *test_exe)
+{
+    char path[MAX_PATH], key_name[MAX_PATH + 64], cmdline[MAX_PATH + 32];
+    DWORD app_disposition, d3d_disposition;
+    PROCESS_INFORMATION pi;
+    STARTUPINFOA si;
+    HKEY app_key, d3d_key;
+    const char *exe, *p;
+    LONG ret;
+
+    GetModuleFileNameA(NULL, path, sizeof(path));
+    exe = path;
+    if ((p = strrchr(exe, '/'))) exe = p + 1;
+    if ((p = strrchr(exe, '\\'))) exe = p + 1;
+    sprintf(key_name, "Software\\Wine\\AppDefaults\\%s", exe);
+
+    ret = RegCreateKeyExA(HKEY_CURRENT_USER, key_name, 0, NULL, 0, KEY_ALL_ACCESS,
+            NULL, &app_key, &app_disposition);
+    if (ret)
+    {
+        skip("Failed to create %s, error %d.\n", key_name, ret);
+        return;
+    }
+    ret = RegCreateKeyExA(app_key, "Direct3D", 0, NULL, 0, KEY_ALL_ACCESS,
+            NULL, &d3d_key, &d3d_disposition);
+    if (ret)
+    {
+        skip("Failed to create the Direct3D key, error %d.\n", ret);
+        RegCloseKey(app_key);
+        return;
+    }
+    if (!RegQueryValueExA(d3d_key, "CSMT", NULL, NULL, NULL, NULL))
+    {
+        skip("CSMT is already configured for %s.\n", exe);
+        RegCloseKey(d3d_key);
+        RegCloseKey(app_key);
+        return;
+    }
+    RegSetValueExA(d3d_key, "CSMT", 0, REG_SZ, (const BYTE *)"enabled", sizeof("enabled"));
+
+    sprintf(cmdline, "\"%s\" visual csmt", test_exe);
+    memset(&si, 0, sizeof(si));
+    si.cb = sizeof(si);
+    ret = CreateProcessA(NULL, cmdline, NULL, NULL, FALSE, 0, NULL, NULL, &si, &pi);
+    ok(ret, "Failed to start the child process, error %u.\n", GetLastError());
+    if (ret)
+    {
+        winetest_wait_child_process(pi.hProcess);
+        CloseHandle(pi.hProcess);
+        CloseHandle(pi.hThread);
+    }
+
+    RegDeleteValueA(d3d_key, "CSMT");
+    RegCloseKey(d3d_key);
+    if (d3d_disposition == REG_CREATED_NEW_KEY)
+        RegDeleteKeyA(app_key, "Direct3D");
+    RegCloseKey(app_key);
+    if (app_disposition == REG_CREATED_NEW_KEY)
+        RegDeleteKeyA(HKEY_CURRENT_USER, key_name);
+}
+
 START_TEST(visual)
 {
     D3DADAPTER_IDENTIFIER9 identifier;
     IDirect3D9 *d3d;
+    BOOL csmt_child;
+    char **argv;
     HRESULT hr;
+    int argc;
+
+    argc = winetest_get_mainargs(&argv);
+    if ((csmt_child = argc >= 3 && !strcmp(argv[2], "csmt")))
+        trace("Running with the multithreaded command stream.\n");
 
     if (!(d3d = Direct3DCreate9(D3D_SDK_VERSION)))
     {
@@ -16654,4 +16725,7 @@ START_TEST(visual)
     resz_test();
     stencil_cull_test();
     test_per_stage_constant();
+
+    if (!csmt_child)
+        test_csmt(argv[0]);
 }
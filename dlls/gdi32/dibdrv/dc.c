@@ -279,9 +279,16 @@ int get_clipped_rects( const dib_info *dib, const RECT *rc, HRGN clip, struct cl
 
     if (!(region = get_wine_region( clip ))) return 0;
 
-    for (i = 0; i < region->numRects; i++)
+    for (i = region_find_band( region, rect.top ); i < region->numRects; i++)
     {
         if (region->rects[i].top >= rect.bottom) break;
+        if (region->rects[i].left >= rect.right)
+        {
+            /* skip the rest of the band */
+            int top = region->rects[i].top;
+            while (i + 1 < region->numRects && region->rects[i + 1].top == top) i++;
+            continue;
+        }
         if (!intersect_rect( out, &rect, &region->rects[i] )) continue;
         out++;
         if (out == &clip_rects->buffer[sizeof(clip_rects->buffer) / sizeof(RECT)])
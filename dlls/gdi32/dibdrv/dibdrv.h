@@ -83,6 +83,10 @@ struct intensity_range
     BYTE r_min, r_max;
     BYTE g_min, g_max;
     BYTE b_min, b_max;
+    /* 32.32 fixed-point blend factors towards min/max, see get_aa_ranges() */
+    ULONGLONG r_lo, r_hi;
+    ULONGLONG g_lo, g_hi;
+    ULONGLONG b_lo, b_hi;
 };
 
 typedef struct dibdrv_physdev
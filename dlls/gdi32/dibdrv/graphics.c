@@ -436,15 +436,39 @@ static inline void get_range( BYTE aa, DWORD text_comp, BYTE *min_comp, BYTE *ma
     *max_comp = ramp[16 - aa] + ((0xff - ramp[16 - aa]) * text_comp) / 0xff;
 }
 
+/* The interpolation needs a division by the text component (or its
+   complement) for every pixel.  Since both the range and the divisor are
+   fixed for a given string, we turn them into a single 32.32 fixed-point
+   factor here.  With a divisor d <= 0xff and a product diff * range <= 0xfe01
+   the reciprocal floor(2^32 / d) + 1 gives exactly the same result as the
+   integer division. */
+static inline ULONGLONG get_blend_factor( DWORD range, DWORD div )
+{
+    if (!div) return 0;
+    return range * (0xffffffffull / div + 1);
+}
+
+static inline void get_blend_factors( DWORD text_comp, BYTE min_comp, BYTE max_comp,
+                                      ULONGLONG *lo, ULONGLONG *hi )
+{
+    *lo = get_blend_factor( text_comp - min_comp, text_comp );
+    *hi = get_blend_factor( max_comp - text_comp, 0xff - text_comp );
+}
+
 static inline void get_aa_ranges( COLORREF col, struct intensity_range intensities[17] )
 {
     int i;
 
     for (i = 0; i < 17; i++)
     {
-        get_range( i, GetRValue(col), &intensities[i].r_min, &intensities[i].r_max );
-        get_range( i, GetGValue(col), &intensities[i].g_min, &intensities[i].g_max );
-        get_range( i, GetBValue(col), &intensities[i].b_min, &intensities[i].b_max );
+        struct intensity_range *range = intensities + i;
+
+        get_range( i, GetRValue(col), &range->r_min, &range->r_max );
+        get_range( i, GetGValue(col), &range->g_min, &range->g_max );
+        get_range( i, GetBValue(col), &range->b_min, &range->b_max );
+        get_blend_factors( GetRValue(col), range->r_min, range->r_max, &range->r_lo, &range->r_hi );
+        get_blend_factors( GetGValue(col), range->g_min, range->g_max, &range->g_lo, &range->g_hi );
+        get_blend_factors( GetBValue(col), range->b_min, range->b_max, &range->b_lo, &range->b_hi );
     }
 }
 
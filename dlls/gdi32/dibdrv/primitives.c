@@ -4914,31 +4914,19 @@ static BOOL gradient_rect_null( const dib_info *dib, const RECT *rc, const TRIVE
     return TRUE;
 }
 
-static inline BYTE aa_color( BYTE dst, BYTE text, BYTE min_comp, BYTE max_comp )
+static inline BYTE aa_color( BYTE dst, BYTE text, ULONGLONG lo, ULONGLONG hi )
 {
-    if (dst == text) return dst;
-
-    if (dst > text)
-    {
-        DWORD diff = dst - text;
-        DWORD range = max_comp - text;
-        dst = text + (diff * range ) / (0xff - text);
-        return dst;
-    }
-    else
-    {
-        DWORD diff = text - dst;
-        DWORD range = text - min_comp;
-        dst = text - (diff * range) / text;
-        return dst;
-    }
+    /* equivalent to interpolating between text and min_comp (or max_comp) and
+       dividing by text (or 0xff - text), see get_aa_ranges() */
+    if (dst > text) return text + (((dst - text) * hi) >> 32);
+    return text - (((text - dst) * lo) >> 32);
 }
 
 static inline DWORD aa_rgb( BYTE r_dst, BYTE g_dst, BYTE b_dst, DWORD text, const struct intensity_range *range )
 {
-    return (aa_color( b_dst, text,       range->b_min, range->b_max )      |
-            aa_color( g_dst, text >> 8,  range->g_min, range->g_max ) << 8 |
-            aa_color( r_dst, text >> 16, range->r_min, range->r_max ) << 16);
+    return (aa_color( b_dst, text,       range->b_lo, range->b_hi )      |
+            aa_color( g_dst, text >> 8,  range->g_lo, range->g_hi ) << 8 |
+            aa_color( r_dst, text >> 16, range->r_lo, range->r_hi ) << 16);
 }
 
 static void draw_glyph_8888( const dib_info *dib, const RECT *rect, const dib_info *glyph,
@@ -5171,7 +5159,8 @@ static void draw_subpixel_glyph_8888( const dib_info *dib, const RECT *rect, con
         for (x = 0; x < rect->right - rect->left; x++)
         {
             if (glyph_ptr[x] == 0) continue;
-            dst_ptr[x] = blend_subpixel( dst_ptr[x] >> 16, dst_ptr[x] >> 8, dst_ptr[x], text_pixel, glyph_ptr[x] );
+            if ((glyph_ptr[x] & 0xffffff) == 0xffffff) dst_ptr[x] = text_pixel & 0xffffff;
+            else dst_ptr[x] = blend_subpixel( dst_ptr[x] >> 16, dst_ptr[x] >> 8, dst_ptr[x], text_pixel, glyph_ptr[x] );
         }
         dst_ptr += dib->stride / 4;
         glyph_ptr += glyph->stride / 4;
@@ -5195,10 +5184,11 @@ static void draw_subpixel_glyph_32( const dib_info *dib, const RECT *rect, const
         for (x = 0; x < rect->right - rect->left; x++)
         {
             if (glyph_ptr[x] == 0) continue;
-            val = blend_subpixel( get_field(dst_ptr[x], dib->red_shift,   dib->red_len),
-                                  get_field(dst_ptr[x], dib->green_shift, dib->green_len),
-                                  get_field(dst_ptr[x], dib->blue_shift,  dib->blue_len),
-                                  text, glyph_ptr[x] );
+            if ((glyph_ptr[x] & 0xffffff) == 0xffffff) val = text;
+            else val = blend_subpixel( get_field(dst_ptr[x], dib->red_shift,   dib->red_len),
+                                       get_field(dst_ptr[x], dib->green_shift, dib->green_len),
+                                       get_field(dst_ptr[x], dib->blue_shift,  dib->blue_len),
+                                       text, glyph_ptr[x] );
             dst_ptr[x] = (put_field( val >> 16, dib->red_shift,   dib->red_len )   |
                           put_field( val >> 8,  dib->green_shift, dib->green_len ) |
                           put_field( val,       dib->blue_shift,  dib->blue_len ));
@@ -5221,8 +5211,9 @@ static void draw_subpixel_glyph_24( const dib_info *dib, const RECT *rect, const
         for (x = 0; x < rect->right - rect->left; x++)
         {
             if (glyph_ptr[x] == 0) continue;
-            val = blend_subpixel( dst_ptr[x * 3 + 2], dst_ptr[x * 3 + 1], dst_ptr[x * 3],
-                                  text_pixel, glyph_ptr[x] );
+            if ((glyph_ptr[x] & 0xffffff) == 0xffffff) val = text_pixel;
+            else val = blend_subpixel( dst_ptr[x * 3 + 2], dst_ptr[x * 3 + 1], dst_ptr[x * 3],
+                                       text_pixel, glyph_ptr[x] );
             dst_ptr[x * 3]     = val;
             dst_ptr[x * 3 + 1] = val >> 8;
             dst_ptr[x * 3 + 2] = val >> 16;
@@ -5249,10 +5240,11 @@ static void draw_subpixel_glyph_555( const dib_info *dib, const RECT *rect, cons
         for (x = 0; x < rect->right - rect->left; x++)
         {
             if (glyph_ptr[x] == 0) continue;
-            val = blend_subpixel( ((dst_ptr[x] >> 7) & 0xf8) | ((dst_ptr[x] >> 12) & 0x07),
-                                  ((dst_ptr[x] >> 2) & 0xf8) | ((dst_ptr[x] >>  7) & 0x07),
-                                  ((dst_ptr[x] << 3) & 0xf8) | ((dst_ptr[x] >>  2) & 0x07),
-                                  text, glyph_ptr[x] );
+            if ((glyph_ptr[x] & 0xffffff) == 0xffffff) val = text;
+            else val = blend_subpixel( ((dst_ptr[x] >> 7) & 0xf8) | ((dst_ptr[x] >> 12) & 0x07),
+                                       ((dst_ptr[x] >> 2) & 0xf8) | ((dst_ptr[x] >>  7) & 0x07),
+                                       ((dst_ptr[x] << 3) & 0xf8) | ((dst_ptr[x] >>  2) & 0x07),
+                                       text, glyph_ptr[x] );
             dst_ptr[x] = ((val >> 9) & 0x7c00) | ((val >> 6) & 0x03e0) | ((val >> 3) & 0x001f);
         }
         dst_ptr += dib->stride / 2;
@@ -5277,10 +5269,11 @@ static void draw_subpixel_glyph_16( const dib_info *dib, const RECT *rect, const
         for (x = 0; x < rect->right - rect->left; x++)
         {
             if (glyph_ptr[x] == 0) continue;
-            val = blend_subpixel( get_field(dst_ptr[x], dib->red_shift,   dib->red_len),
-                                  get_field(dst_ptr[x], dib->green_shift, dib->green_len),
-                                  get_field(dst_ptr[x], dib->blue_shift,  dib->blue_len),
-                                  text, glyph_ptr[x] );
+            if ((glyph_ptr[x] & 0xffffff) == 0xffffff) val = text;
+            else val = blend_subpixel( get_field(dst_ptr[x], dib->red_shift,   dib->red_len),
+                                       get_field(dst_ptr[x], dib->green_shift, dib->green_len),
+                                       get_field(dst_ptr[x], dib->blue_shift,  dib->blue_len),
+                                       text, glyph_ptr[x] );
             dst_ptr[x] = (put_field( val >> 16, dib->red_shift,   dib->red_len )   |
                           put_field( val >> 8,  dib->green_shift, dib->green_len ) |
                           put_field( val,       dib->blue_shift,  dib->blue_len ));
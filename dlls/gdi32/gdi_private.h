@@ -346,6 +346,21 @@ static inline void release_wine_region(HRGN rgn)
     GDI_ReleaseObj(rgn);
 }
 
+/* Regions are stored in y-x banded order, so the bottoms of the rectangles never decrease.
+ * Return the index of the first rectangle that extends below y. */
+static inline int region_find_band( const WINEREGION *region, int y )
+{
+    int low = 0, high = region->numRects;
+
+    while (low < high)
+    {
+        int pos = (low + high) / 2;
+        if (region->rects[pos].bottom <= y) low = pos + 1;
+        else high = pos;
+    }
+    return low;
+}
+
 /* null driver entry points */
 extern BOOL nulldrv_AbortPath( PHYSDEV dev ) DECLSPEC_HIDDEN;
 extern BOOL nulldrv_AlphaBlend( PHYSDEV dst_dev, struct bitblt_coords *dst,
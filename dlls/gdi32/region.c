@@ -1045,12 +1045,15 @@ BOOL WINAPI PtInRegion( HRGN hrgn, INT x, INT y )
 	int i;
 
 	if (obj->numRects > 0 && is_in_rect(&obj->extents, x, y))
-	    for (i = 0; i < obj->numRects; i++)
+	    for (i = region_find_band( obj, y ); i < obj->numRects; i++)
+            {
+                if (obj->rects[i].top > y) break;
 		if (is_in_rect(&obj->rects[i], x, y))
                 {
 		    ret = TRUE;
                     break;
                 }
+            }
 	GDI_ReleaseObj( hrgn );
     }
     return ret;
@@ -1088,7 +1091,7 @@ BOOL WINAPI RectInRegion( HRGN hrgn, const RECT *rect )
     /* this is (just) a useful optimization */
 	if ((obj->numRects > 0) && overlapping(&obj->extents, &rc))
 	{
-	    for (pCurRect = obj->rects, pRectEnd = pCurRect +
+	    for (pCurRect = obj->rects + region_find_band( obj, rc.top ), pRectEnd = obj->rects +
 	     obj->numRects; pCurRect < pRectEnd; pCurRect++)
 	    {
 	        if (pCurRect->bottom <= rc.top)
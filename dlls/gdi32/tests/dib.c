@@ -2840,7 +2840,8 @@ static inline COLORREF aa_colorref( COLORREF dst, COLORREF text, BYTE glyph )
 
 static const BYTE masks[8] = {0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01};
 
-static void draw_text_2( HDC hdc, const BITMAPINFO *bmi, BYTE *bits, BOOL aa )
+static void draw_text_2( HDC hdc, const BITMAPINFO *bmi, BYTE *bits, BOOL aa,
+                         const BYTE vals[4], COLORREF color )
 {
     DWORD dib_size = get_dib_size(bmi), ret;
     LOGFONTA lf;
@@ -2852,7 +2853,6 @@ static void draw_text_2( HDC hdc, const BITMAPINFO *bmi, BYTE *bits, BOOL aa )
     char *eto_hash = NULL, *diy_hash = NULL;
     static const char str[] = "Hello Wine";
     POINT origin, g_org;
-    static const BYTE vals[4] = { 0x00, 0x00, 0x00, 0x00 };
     TEXTMETRICA tm;
     COLORREF text_color;
 
@@ -2875,7 +2875,7 @@ static void draw_text_2( HDC hdc, const BITMAPINFO *bmi, BYTE *bits, BOOL aa )
         return;
     }
 
-    SetTextColor( hdc, RGB(0xff, 0x00, 0x00) );
+    SetTextColor( hdc, color );
     SetTextAlign( hdc, TA_BASELINE );
     SetBkMode( hdc, TRANSPARENT );
     origin.x = 10;
@@ -2947,7 +2947,7 @@ static void draw_text_2( HDC hdc, const BITMAPINFO *bmi, BYTE *bits, BOOL aa )
     }
 
     diy_hash = hash_dib( bmi, bits );
-    ok( !strcmp( eto_hash, diy_hash ), "hash mismatch - aa %d\n", aa );
+    ok( !strcmp( eto_hash, diy_hash ), "hash mismatch - aa %d color %08x\n", aa, color );
 
     HeapFree( GetProcessHeap(), 0, diy_hash );
     HeapFree( GetProcessHeap(), 0, eto_hash );
@@ -2958,14 +2958,20 @@ static void draw_text_2( HDC hdc, const BITMAPINFO *bmi, BYTE *bits, BOOL aa )
 
 static void draw_text( HDC hdc, const BITMAPINFO *bmi, BYTE *bits )
 {
-    draw_text_2( hdc, bmi, bits, FALSE );
+    static const BYTE black[4] = { 0x00, 0x00, 0x00, 0x00 };
+    static const BYTE mixed[4] = { 0x30, 0xc8, 0x7f, 0xf0 };
+
+    draw_text_2( hdc, bmi, bits, FALSE, black, RGB(0xff, 0x00, 0x00) );
 
     /* Rounding errors make these cases hard to test */
     if ((bmi->bmiHeader.biCompression == BI_BITFIELDS && ((DWORD*)bmi->bmiColors)[0] == 0x3f000) ||
         (bmi->bmiHeader.biBitCount == 16))
         return;
 
-    draw_text_2( hdc, bmi, bits, TRUE );
+    draw_text_2( hdc, bmi, bits, TRUE, black, RGB(0xff, 0x00, 0x00) );
+    /* blend both towards lighter and darker backgrounds */
+    if (bmi->bmiHeader.biBitCount > 8)
+        draw_text_2( hdc, bmi, bits, TRUE, mixed, RGB(0x40, 0xa0, 0xe0) );
 }
 
 static void test_simple_graphics(void)
@@ -285,6 +285,9 @@ static void test_region(void)
     HRGN hrgn = CreateRectRgn(10, 10, 20, 20);
     RECT rc = { 5, 5, 15, 15 };
     BOOL ret = RectInRegion( hrgn, &rc);
+    HRGN cell;
+    int x, y;
+
     ok( ret, "RectInRegion should return TRUE\n");
     /* swap left and right */
     SetRect( &rc, 15, 5, 5, 15 );
@@ -317,6 +320,40 @@ static void test_region(void)
     ret = RectInRegion( hrgn, &rc);
     ok( ret, "RectInRegion should return TRUE\n");
     DeleteObject(hrgn);
+
+    /* checkerboard with many bands */
+    hrgn = CreateRectRgn( 0, 0, 0, 0 );
+    for (y = 0; y < 16; y++)
+        for (x = y % 2; x < 16; x += 2)
+        {
+            cell = CreateRectRgn( x * 10, y * 10, x * 10 + 10, y * 10 + 10 );
+            CombineRgn( hrgn, hrgn, cell, RGN_OR );
+            DeleteObject( cell );
+        }
+
+    for (y = 0; y < 16; y++)
+        for (x = 0; x < 16; x++)
+        {
+            BOOL expect = (x + y) % 2 == 0;
+
+            ret = PtInRegion( hrgn, x * 10 + 5, y * 10 + 5 );
+            ok( ret == expect, "%d,%d: PtInRegion returned %d\n", x, y, ret );
+            ret = PtInRegion( hrgn, x * 10, y * 10 );
+            ok( ret == expect, "%d,%d: PtInRegion returned %d\n", x, y, ret );
+            ret = PtInRegion( hrgn, x * 10 + 9, y * 10 + 9 );
+            ok( ret == expect, "%d,%d: PtInRegion returned %d\n", x, y, ret );
+
+            SetRect( &rc, x * 10 + 2, y * 10 + 2, x * 10 + 8, y * 10 + 8 );
+            ret = RectInRegion( hrgn, &rc );
+            ok( ret == expect, "%d,%d: RectInRegion returned %d\n", x, y, ret );
+        }
+
+    ret = PtInRegion( hrgn, 165, 5 );
+    ok( !ret, "PtInRegion returned %d\n", ret );
+    SetRect( &rc, 12, 2, 28, 8 );
+    ret = RectInRegion( hrgn, &rc );
+    ok( ret, "RectInRegion returned %d\n", ret );
+    DeleteObject( hrgn );
 }
 
 static void test_handles_on_win64(void)
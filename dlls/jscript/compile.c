@@ -1804,6 +1804,7 @@ void release_bytecode(bytecode_t *code)
     heap_pool_free(&code->heap);
     heap_free(code->bstr_pool);
     heap_free(code->str_pool);
+    heap_free(code->id_cache);
     heap_free(code->instrs);
     heap_free(code);
 }
@@ -1992,6 +1993,7 @@ HRESULT compile_script(script_ctx_t *ctx, const WCHAR *code, const WCHAR *args,
         BOOL from_eval, BOOL use_decode, bytecode_t **ret)
 {
     compiler_ctx_t compiler = {0};
+    unsigned i;
     HRESULT hres;
 
     hres = init_code(&compiler, code);
@@ -2025,6 +2027,14 @@ HRESULT compile_script(script_ctx_t *ctx, const WCHAR *code, const WCHAR *args,
         return hres;
     }
 
+    compiler.code->id_cache = heap_alloc(compiler.code_off * sizeof(*compiler.code->id_cache));
+    if(!compiler.code->id_cache) {
+        release_bytecode(compiler.code);
+        return E_OUTOFMEMORY;
+    }
+    for(i=0; i < compiler.code_off; i++)
+        compiler.code->id_cache[i] = DISPID_UNKNOWN;
+
     *ret = compiler.code;
     return S_OK;
 }
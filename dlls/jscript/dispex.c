@@ -19,6 +19,7 @@
 #include <assert.h>
 
 #include "jscript.h"
+#include "engine.h"
 
 #include "wine/unicode.h"
 #include "wine/debug.h"
@@ -917,6 +918,8 @@ HRESULT init_dispex(jsdisp_t *dispex, script_ctx_t *ctx, const builtin_info_t *b
     script_addref(ctx);
     dispex->ctx = ctx;
 
+    list_add_tail(&ctx->objects, &dispex->gc_entry);
+    ctx->object_cnt++;
     return S_OK;
 }
 
@@ -953,6 +956,9 @@ void jsdisp_free(jsdisp_t *obj)
 
     TRACE("(%p)\n", obj);
 
+    list_remove(&obj->gc_entry);
+    obj->ctx->object_cnt--;
+
     for(prop = obj->props; prop < obj->props+obj->prop_cnt; prop++) {
         if(prop->type == PROP_JSVAL)
             jsval_release(prop->u.val);
@@ -969,6 +975,221 @@ void jsdisp_free(jsdisp_t *obj)
         heap_free(obj);
 }
 
+/*
+ * Cycle collector. Objects are reference counted, so cycles between them
+ * (typically a closure stored in a property of an object from its own scope)
+ * are never freed. gc_run finds them by trial deletion: references held by
+ * other objects of the script are subtracted from each object's reference
+ * count, objects left with a positive count are referenced from outside and
+ * everything reachable from them is alive. The remaining objects are only
+ * referenced from each other, so their properties and scopes are cleared to
+ * break the cycles.
+ */
+
+/* Don't bother collecting until the script has this many live objects */
+#define GC_MIN_THRESHOLD 10000
+
+struct gc_ctx_t {
+    script_ctx_t *script;
+    BOOL mark;
+
+    jsdisp_t **stack;
+    unsigned stack_size;
+    unsigned stack_top;
+
+    scope_chain_t **scopes;
+    unsigned scopes_size;
+    unsigned scope_cnt;
+
+    BOOL oom;
+};
+
+static BOOL gc_grow(gc_ctx_t *gc_ctx, void **array, unsigned *size, unsigned cnt, unsigned elem_size)
+{
+    void *new_array;
+
+    if(cnt < *size)
+        return TRUE;
+
+    new_array = *array ? heap_realloc(*array, *size*2*elem_size) : heap_alloc(32*elem_size);
+    if(!new_array) {
+        gc_ctx->oom = TRUE;
+        return FALSE;
+    }
+
+    *size = *array ? *size*2 : 32;
+    *array = new_array;
+    return TRUE;
+}
+
+void gc_visit_obj(gc_ctx_t *gc_ctx, jsdisp_t *obj)
+{
+    /* Objects of other script contexts are not tracked by this one */
+    if(obj->ctx != gc_ctx->script)
+        return;
+
+    if(!gc_ctx->mark) {
+        obj->gc_ref--;
+        return;
+    }
+
+    if(obj->gc_marked)
+        return;
+
+    obj->gc_marked = TRUE;
+    if(gc_grow(gc_ctx, (void**)&gc_ctx->stack, &gc_ctx->stack_size, gc_ctx->stack_top, sizeof(*gc_ctx->stack)))
+        gc_ctx->stack[gc_ctx->stack_top++] = obj;
+}
+
+void gc_visit_scope(gc_ctx_t *gc_ctx, scope_chain_t *scope)
+{
+    if(!gc_ctx->mark) {
+        /* Scopes are shared between functions, subtract their own references only once */
+        if(!scope->gc_visited) {
+            if(!gc_grow(gc_ctx, (void**)&gc_ctx->scopes, &gc_ctx->scopes_size, gc_ctx->scope_cnt,
+                        sizeof(*gc_ctx->scopes)))
+                return;
+
+            gc_ctx->scopes[gc_ctx->scope_cnt++] = scope;
+            scope->gc_visited = TRUE;
+            scope->gc_ref = scope->ref;
+
+            if(scope->next)
+                gc_visit_scope(gc_ctx, scope->next);
+            if(scope->jsobj)
+                gc_visit_obj(gc_ctx, scope->jsobj);
+        }
+
+        scope->gc_ref--;
+        return;
+    }
+
+    if(scope->gc_marked || !scope->gc_visited)
+        return;
+
+    scope->gc_marked = TRUE;
+    if(scope->next)
+        gc_visit_scope(gc_ctx, scope->next);
+    if(scope->jsobj)
+        gc_visit_obj(gc_ctx, scope->jsobj);
+}
+
+static void gc_traverse(gc_ctx_t *gc_ctx, jsdisp_t *obj)
+{
+    dispex_prop_t *prop;
+    jsdisp_t *jsdisp;
+
+    for(prop = obj->props; prop < obj->props+obj->prop_cnt; prop++) {
+        if(prop->type != PROP_JSVAL || !is_object_instance(prop->u.val) || !get_object(prop->u.val))
+            continue;
+
+        jsdisp = to_jsdisp(get_object(prop->u.val));
+        if(jsdisp)
+            gc_visit_obj(gc_ctx, jsdisp);
+    }
+
+    if(obj->prototype)
+        gc_visit_obj(gc_ctx, obj->prototype);
+
+    if(obj->builtin_info->gc_traverse)
+        obj->builtin_info->gc_traverse(gc_ctx, obj);
+}
+
+static void gc_unlink(jsdisp_t *obj)
+{
+    dispex_prop_t *prop;
+    jsval_t val;
+
+    for(prop = obj->props; prop < obj->props+obj->prop_cnt; prop++) {
+        if(prop->type != PROP_JSVAL)
+            continue;
+
+        val = prop->u.val;
+        prop->u.val = jsval_undefined();
+        jsval_release(val);
+    }
+
+    if(obj->builtin_info->gc_unlink)
+        obj->builtin_info->gc_unlink(obj);
+}
+
+HRESULT gc_run(script_ctx_t *ctx)
+{
+    jsdisp_t *obj, **garbage = NULL;
+    unsigned i, garbage_cnt = 0, obj_cnt = ctx->object_cnt;
+    gc_ctx_t gc_ctx;
+
+    TRACE("%u objects\n", obj_cnt);
+
+    memset(&gc_ctx, 0, sizeof(gc_ctx));
+    gc_ctx.script = ctx;
+
+    /* Subtract the references held by the script's own objects */
+    LIST_FOR_EACH_ENTRY(obj, &ctx->objects, jsdisp_t, gc_entry) {
+        obj->gc_ref = obj->ref;
+        obj->gc_marked = FALSE;
+    }
+    LIST_FOR_EACH_ENTRY(obj, &ctx->objects, jsdisp_t, gc_entry)
+        gc_traverse(&gc_ctx, obj);
+
+    /* Mark everything reachable from objects referenced from outside */
+    gc_ctx.mark = TRUE;
+    for(i = 0; i < gc_ctx.scope_cnt; i++) {
+        if(gc_ctx.scopes[i]->gc_ref > 0)
+            gc_visit_scope(&gc_ctx, gc_ctx.scopes[i]);
+    }
+    LIST_FOR_EACH_ENTRY(obj, &ctx->objects, jsdisp_t, gc_entry) {
+        if(obj->gc_ref > 0)
+            gc_visit_obj(&gc_ctx, obj);
+
+        while(gc_ctx.stack_top)
+            gc_traverse(&gc_ctx, gc_ctx.stack[--gc_ctx.stack_top]);
+    }
+
+    for(i = 0; i < gc_ctx.scope_cnt; i++)
+        gc_ctx.scopes[i]->gc_visited = gc_ctx.scopes[i]->gc_marked = FALSE;
+    heap_free(gc_ctx.scopes);
+    heap_free(gc_ctx.stack);
+
+    if(!gc_ctx.oom) {
+        LIST_FOR_EACH_ENTRY(obj, &ctx->objects, jsdisp_t, gc_entry) {
+            if(!obj->gc_marked)
+                garbage_cnt++;
+        }
+    }
+
+    if(garbage_cnt) {
+        garbage = heap_alloc(garbage_cnt * sizeof(*garbage));
+        if(garbage) {
+            /* Keep the garbage alive until all the cycles are broken */
+            i = 0;
+            LIST_FOR_EACH_ENTRY(obj, &ctx->objects, jsdisp_t, gc_entry) {
+                if(!obj->gc_marked)
+                    garbage[i++] = jsdisp_addref(obj);
+            }
+
+            for(i = 0; i < garbage_cnt; i++)
+                gc_unlink(garbage[i]);
+            for(i = 0; i < garbage_cnt; i++)
+                jsdisp_release(garbage[i]);
+            heap_free(garbage);
+        }else {
+            garbage_cnt = 0;
+            gc_ctx.oom = TRUE;
+        }
+    }
+
+    ctx->gc_threshold = max(GC_MIN_THRESHOLD, ctx->object_cnt*2);
+    TRACE("collected %u of %u objects%s\n", garbage_cnt, obj_cnt, gc_ctx.oom ? " (out of memory)" : "");
+    return gc_ctx.oom ? E_OUTOFMEMORY : S_OK;
+}
+
+void gc_check(script_ctx_t *ctx)
+{
+    if(ctx->object_cnt >= max(ctx->gc_threshold, GC_MIN_THRESHOLD))
+        gc_run(ctx);
+}
+
 #ifdef TRACE_REFCNT
 
 jsdisp_t *jsdisp_addref(jsdisp_t *jsdisp)
@@ -1053,6 +1274,28 @@ HRESULT jsdisp_get_id(jsdisp_t *jsdisp, const WCHAR *name, DWORD flags, DISPID *
     return DISP_E_UNKNOWNNAME;
 }
 
+/*
+ * Same as jsdisp_get_id, but first tries *hint, the result of an earlier lookup
+ * of the same name. Objects built the same way share their property layout, so
+ * the hint is often valid for other objects than the one it came from as well.
+ */
+HRESULT jsdisp_get_id_hint(jsdisp_t *jsdisp, const WCHAR *name, DWORD flags, DISPID *hint, DISPID *id)
+{
+    dispex_prop_t *prop;
+    HRESULT hres;
+
+    prop = get_prop(jsdisp, *hint);
+    if(prop && prop->name && !strcmpW(prop->name, name)) {
+        *id = *hint;
+        return S_OK;
+    }
+
+    hres = jsdisp_get_id(jsdisp, name, flags, id);
+    if(SUCCEEDED(hres))
+        *hint = *id;
+    return hres;
+}
+
 HRESULT jsdisp_call_value(jsdisp_t *jsfunc, IDispatch *jsthis, WORD flags, unsigned argc, jsval_t *argv, jsval_t *r)
 {
     HRESULT hres;
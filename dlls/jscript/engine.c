@@ -124,6 +124,28 @@ static void stack_popn(exec_ctx_t *ctx, unsigned n)
         jsval_release(stack_pop(ctx));
 }
 
+/*
+ * Fast path for binary operators: if both operands on top of the stack are
+ * numbers, returns them without going through the generic conversions. The
+ * caller replaces them with the result using stack_set_binop_result.
+ */
+static inline BOOL stack_top_numbers(exec_ctx_t *ctx, double *l, double *r)
+{
+    if(ctx->top < 2 || !is_number(ctx->stack[ctx->top-1]) || !is_number(ctx->stack[ctx->top-2]))
+        return FALSE;
+
+    *l = get_number(ctx->stack[ctx->top-2]);
+    *r = get_number(ctx->stack[ctx->top-1]);
+    return TRUE;
+}
+
+static inline HRESULT stack_set_binop_result(exec_ctx_t *ctx, jsval_t v)
+{
+    /* Numbers don't need to be released */
+    ctx->stack[--ctx->top-1] = v;
+    return S_OK;
+}
+
 static HRESULT stack_pop_number(exec_ctx_t *ctx, double *r)
 {
     jsval_t v;
@@ -236,6 +258,7 @@ HRESULT scope_push(scope_chain_t *scope, jsdisp_t *jsobj, IDispatch *obj, scope_
         return E_OUTOFMEMORY;
 
     new_scope->ref = 1;
+    new_scope->gc_visited = new_scope->gc_marked = FALSE;
 
     IDispatch_AddRef(obj);
     new_scope->jsobj = jsobj;
@@ -492,7 +515,7 @@ static BOOL lookup_global_members(script_ctx_t *ctx, BSTR identifier, exprval_t
 }
 
 /* ECMA-262 3rd Edition    10.1.4 */
-static HRESULT identifier_eval(script_ctx_t *ctx, BSTR identifier, exprval_t *ret)
+static HRESULT identifier_eval(script_ctx_t *ctx, BSTR identifier, DISPID *id_cache, exprval_t *ret)
 {
     scope_chain_t *scope;
     named_item_t *item;
@@ -503,7 +526,7 @@ static HRESULT identifier_eval(script_ctx_t *ctx, BSTR identifier, exprval_t *re
 
     for(scope = ctx->exec_ctx->scope_chain; scope; scope = scope->next) {
         if(scope->jsobj)
-            hres = jsdisp_get_id(scope->jsobj, identifier, fdexNameImplicit, &id);
+            hres = jsdisp_get_id_hint(scope->jsobj, identifier, fdexNameImplicit, id_cache, &id);
         else
             hres = disp_get_id(ctx, scope->obj, identifier, identifier, fdexNameImplicit, &id);
         if(SUCCEEDED(hres)) {
@@ -512,7 +535,7 @@ static HRESULT identifier_eval(script_ctx_t *ctx, BSTR identifier, exprval_t *re
         }
     }
 
-    hres = jsdisp_get_id(ctx->global, identifier, 0, &id);
+    hres = jsdisp_get_id_hint(ctx->global, identifier, 0, id_cache, &id);
     if(SUCCEEDED(hres)) {
         exprval_set_idref(ret, to_disp(ctx->global), id);
         return S_OK;
@@ -575,6 +598,10 @@ static inline double get_op_double(exec_ctx_t *ctx){
     return ctx->code->instrs[ctx->ip].u.dbl;
 }
 
+static inline DISPID *get_op_id_cache(exec_ctx_t *ctx){
+    return ctx->code->id_cache + ctx->ip;
+}
+
 /* ECMA-262 3rd Edition    12.2 */
 static HRESULT interp_var_set(exec_ctx_t *ctx)
 {
@@ -873,6 +900,7 @@ static HRESULT interp_member(exec_ctx_t *ctx)
 {
     const BSTR arg = get_op_bstr(ctx, 0);
     IDispatch *obj;
+    jsdisp_t *jsdisp;
     jsval_t v;
     DISPID id;
     HRESULT hres;
@@ -883,7 +911,11 @@ static HRESULT interp_member(exec_ctx_t *ctx)
     if(FAILED(hres))
         return hres;
 
-    hres = disp_get_id(ctx->script, obj, arg, arg, 0, &id);
+    jsdisp = to_jsdisp(obj);
+    if(jsdisp)
+        hres = jsdisp_get_id_hint(jsdisp, arg, 0, get_op_id_cache(ctx), &id);
+    else
+        hres = disp_get_id(ctx->script, obj, arg, arg, 0, &id);
     if(SUCCEEDED(hres)) {
         hres = disp_propget(ctx->script, obj, id, &v);
     }else if(hres == DISP_E_UNKNOWNNAME) {
@@ -1056,7 +1088,7 @@ static HRESULT interp_ident(exec_ctx_t *ctx)
 
     TRACE("%s\n", debugstr_w(arg));
 
-    hres = identifier_eval(ctx->script, arg, &exprval);
+    hres = identifier_eval(ctx->script, arg, get_op_id_cache(ctx), &exprval);
     if(FAILED(hres))
         return hres;
 
@@ -1081,7 +1113,7 @@ static HRESULT interp_identid(exec_ctx_t *ctx)
 
     TRACE("%s %x\n", debugstr_w(arg), flags);
 
-    hres = identifier_eval(ctx->script, arg, &exprval);
+    hres = identifier_eval(ctx->script, arg, get_op_id_cache(ctx), &exprval);
     if(FAILED(hres))
         return hres;
 
@@ -1487,8 +1519,12 @@ static HRESULT add_eval(script_ctx_t *ctx, jsval_t lval, jsval_t rval, jsval_t *
 static HRESULT interp_add(exec_ctx_t *ctx)
 {
     jsval_t l, r, ret;
+    double nl, nr;
     HRESULT hres;
 
+    if(stack_top_numbers(ctx, &nl, &nr))
+        return stack_set_binop_result(ctx, jsval_number(nl+nr));
+
     r = stack_pop(ctx);
     l = stack_pop(ctx);
 
@@ -1509,6 +1545,9 @@ static HRESULT interp_sub(exec_ctx_t *ctx)
     double l, r;
     HRESULT hres;
 
+    if(stack_top_numbers(ctx, &l, &r))
+        return stack_set_binop_result(ctx, jsval_number(l-r));
+
     TRACE("\n");
 
     hres = stack_pop_number(ctx, &r);
@@ -1528,6 +1567,9 @@ static HRESULT interp_mul(exec_ctx_t *ctx)
     double l, r;
     HRESULT hres;
 
+    if(stack_top_numbers(ctx, &l, &r))
+        return stack_set_binop_result(ctx, jsval_number(l*r));
+
     TRACE("\n");
 
     hres = stack_pop_number(ctx, &r);
@@ -1547,6 +1589,9 @@ static HRESULT interp_div(exec_ctx_t *ctx)
     double l, r;
     HRESULT hres;
 
+    if(stack_top_numbers(ctx, &l, &r))
+        return stack_set_binop_result(ctx, jsval_number(l/r));
+
     TRACE("\n");
 
     hres = stack_pop_number(ctx, &r);
@@ -1626,7 +1671,7 @@ static HRESULT interp_delete_ident(exec_ctx_t *ctx)
 
     TRACE("%s\n", debugstr_w(arg));
 
-    hres = identifier_eval(ctx->script, arg, &exprval);
+    hres = identifier_eval(ctx->script, arg, get_op_id_cache(ctx), &exprval);
     if(FAILED(hres))
         return hres;
 
@@ -1736,7 +1781,7 @@ static HRESULT interp_typeofident(exec_ctx_t *ctx)
 
     TRACE("%s\n", debugstr_w(arg));
 
-    hres = identifier_eval(ctx->script, arg, &exprval);
+    hres = identifier_eval(ctx->script, arg, get_op_id_cache(ctx), &exprval);
     if(FAILED(hres))
         return hres;
 
@@ -2081,8 +2126,12 @@ static HRESULT interp_lt(exec_ctx_t *ctx)
 {
     jsval_t l, r;
     BOOL b;
+    double nl, nr;
     HRESULT hres;
 
+    if(stack_top_numbers(ctx, &nl, &nr))
+        return stack_set_binop_result(ctx, jsval_bool(nl < nr));
+
     r = stack_pop(ctx);
     l = stack_pop(ctx);
 
@@ -2102,8 +2151,12 @@ static HRESULT interp_lteq(exec_ctx_t *ctx)
 {
     jsval_t l, r;
     BOOL b;
+    double nl, nr;
     HRESULT hres;
 
+    if(stack_top_numbers(ctx, &nl, &nr))
+        return stack_set_binop_result(ctx, jsval_bool(nl <= nr));
+
     r = stack_pop(ctx);
     l = stack_pop(ctx);
 
@@ -2123,8 +2176,12 @@ static HRESULT interp_gt(exec_ctx_t *ctx)
 {
     jsval_t l, r;
     BOOL b;
+    double nl, nr;
     HRESULT hres;
 
+    if(stack_top_numbers(ctx, &nl, &nr))
+        return stack_set_binop_result(ctx, jsval_bool(nl > nr));
+
     r = stack_pop(ctx);
     l = stack_pop(ctx);
 
@@ -2144,8 +2201,12 @@ static HRESULT interp_gteq(exec_ctx_t *ctx)
 {
     jsval_t l, r;
     BOOL b;
+    double nl, nr;
     HRESULT hres;
 
+    if(stack_top_numbers(ctx, &nl, &nr))
+        return stack_set_binop_result(ctx, jsval_bool(nl >= nr));
+
     r = stack_pop(ctx);
     l = stack_pop(ctx);
 
@@ -2501,6 +2562,10 @@ HRESULT exec_source(exec_ctx_t *ctx, bytecode_t *code, function_code_t *func, BO
     unsigned i;
     HRESULT hres = S_OK;
 
+    /* Only collect garbage when no script code is running */
+    if(!ctx->script->exec_ctx)
+        gc_check(ctx->script);
+
     for(i = 0; i < func->func_cnt; i++) {
         jsdisp_t *func_obj;
 
@@ -180,6 +180,8 @@ typedef struct _bytecode_t {
     unsigned str_pool_size;
     unsigned str_cnt;
 
+    DISPID *id_cache;
+
     struct _bytecode_t *next;
 } bytecode_t;
 
@@ -211,6 +213,10 @@ typedef struct _scope_chain_t {
     jsdisp_t *jsobj;
     IDispatch *obj;
     struct _scope_chain_t *next;
+
+    LONG gc_ref;
+    BOOL gc_visited;
+    BOOL gc_marked;
 } scope_chain_t;
 
 HRESULT scope_push(scope_chain_t*,jsdisp_t*,IDispatch*,scope_chain_t**) DECLSPEC_HIDDEN;
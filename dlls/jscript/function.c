@@ -92,6 +92,14 @@ static void Arguments_destructor(jsdisp_t *jsdisp)
     heap_free(arguments);
 }
 
+static void Arguments_gc_traverse(gc_ctx_t *gc_ctx, jsdisp_t *jsdisp)
+{
+    ArgumentsInstance *arguments = (ArgumentsInstance*)jsdisp;
+
+    gc_visit_obj(gc_ctx, &arguments->function->dispex);
+    gc_visit_obj(gc_ctx, arguments->var_obj);
+}
+
 static unsigned Arguments_idx_length(jsdisp_t *jsdisp)
 {
     ArgumentsInstance *arguments = (ArgumentsInstance*)jsdisp;
@@ -126,7 +134,8 @@ static const builtin_info_t Arguments_info = {
     NULL,
     Arguments_idx_length,
     Arguments_idx_get,
-    Arguments_idx_put
+    Arguments_idx_put,
+    Arguments_gc_traverse
 };
 
 static HRESULT create_arguments(script_ctx_t *ctx, FunctionInstance *calee, jsdisp_t *var_obj,
@@ -595,6 +604,24 @@ static void Function_destructor(jsdisp_t *dispex)
     heap_free(This);
 }
 
+static void Function_gc_traverse(gc_ctx_t *gc_ctx, jsdisp_t *dispex)
+{
+    FunctionInstance *This = (FunctionInstance*)dispex;
+
+    if(This->scope_chain)
+        gc_visit_scope(gc_ctx, This->scope_chain);
+}
+
+static void Function_gc_unlink(jsdisp_t *dispex)
+{
+    FunctionInstance *This = (FunctionInstance*)dispex;
+
+    if(This->scope_chain) {
+        scope_release(This->scope_chain);
+        This->scope_chain = NULL;
+    }
+}
+
 static const builtin_prop_t Function_props[] = {
     {applyW,                 Function_apply,                 PROPF_METHOD|2},
     {argumentsW,             Function_arguments,             0},
@@ -609,7 +636,12 @@ static const builtin_info_t Function_info = {
     sizeof(Function_props)/sizeof(*Function_props),
     Function_props,
     Function_destructor,
-    NULL
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    Function_gc_traverse,
+    Function_gc_unlink
 };
 
 static const builtin_prop_t FunctionInst_props[] = {
@@ -623,7 +655,12 @@ static const builtin_info_t FunctionInst_info = {
     sizeof(FunctionInst_props)/sizeof(*FunctionInst_props),
     FunctionInst_props,
     Function_destructor,
-    NULL
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    Function_gc_traverse,
+    Function_gc_unlink
 };
 
 static HRESULT create_function(script_ctx_t *ctx, const builtin_info_t *builtin_info, DWORD flags,
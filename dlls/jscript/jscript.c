@@ -217,6 +217,9 @@ static void decrease_state(JScript *This, SCRIPTSTATE state)
                 jsdisp_release(This->ctx->global);
                 This->ctx->global = NULL;
             }
+
+            /* Free the object cycles that were kept alive by the script */
+            gc_run(This->ctx);
             /* FALLTHROUGH */
         case SCRIPTSTATE_UNINITIALIZED:
             change_state(This, state);
@@ -717,6 +720,7 @@ static HRESULT WINAPI JScriptParse_InitNew(IActiveScriptParse *iface)
     ctx->safeopt = This->safeopt;
     ctx->version = This->version;
     ctx->ei.val = jsval_undefined();
+    list_init(&ctx->objects);
     heap_pool_init(&ctx->tmp_heap);
 
     hres = create_jscaller(ctx);
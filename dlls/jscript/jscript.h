@@ -92,6 +92,7 @@ static inline LPWSTR heap_strdupW(LPCWSTR str)
 }
 
 typedef struct jsdisp_t jsdisp_t;
+typedef struct gc_ctx_t gc_ctx_t;
 
 extern HINSTANCE jscript_hinstance DECLSPEC_HIDDEN;
 
@@ -204,6 +205,8 @@ typedef struct {
     unsigned (*idx_length)(jsdisp_t*);
     HRESULT (*idx_get)(jsdisp_t*,unsigned,jsval_t*);
     HRESULT (*idx_put)(jsdisp_t*,unsigned,jsval_t);
+    void (*gc_traverse)(gc_ctx_t*,jsdisp_t*);
+    void (*gc_unlink)(jsdisp_t*);
 } builtin_info_t;
 
 struct jsdisp_t {
@@ -219,6 +222,10 @@ struct jsdisp_t {
     jsdisp_t *prototype;
 
     const builtin_info_t *builtin_info;
+
+    struct list gc_entry;
+    LONG gc_ref;
+    BOOL gc_marked;
 };
 
 static inline IDispatch *to_disp(jsdisp_t *jsdisp)
@@ -277,6 +284,14 @@ HRESULT jsdisp_propput_idx(jsdisp_t*,DWORD,jsval_t) DECLSPEC_HIDDEN;
 HRESULT jsdisp_propget_name(jsdisp_t*,LPCWSTR,jsval_t*) DECLSPEC_HIDDEN;
 HRESULT jsdisp_get_idx(jsdisp_t*,DWORD,jsval_t*) DECLSPEC_HIDDEN;
 HRESULT jsdisp_get_id(jsdisp_t*,const WCHAR*,DWORD,DISPID*) DECLSPEC_HIDDEN;
+HRESULT jsdisp_get_id_hint(jsdisp_t*,const WCHAR*,DWORD,DISPID*,DISPID*) DECLSPEC_HIDDEN;
+
+struct _scope_chain_t;
+
+void gc_visit_obj(gc_ctx_t*,jsdisp_t*) DECLSPEC_HIDDEN;
+void gc_visit_scope(gc_ctx_t*,struct _scope_chain_t*) DECLSPEC_HIDDEN;
+HRESULT gc_run(script_ctx_t*) DECLSPEC_HIDDEN;
+void gc_check(script_ctx_t*) DECLSPEC_HIDDEN;
 HRESULT disp_delete(IDispatch*,DISPID,BOOL*) DECLSPEC_HIDDEN;
 HRESULT disp_delete_name(script_ctx_t*,IDispatch*,jsstr_t*,BOOL*);
 HRESULT jsdisp_delete_idx(jsdisp_t*,DWORD) DECLSPEC_HIDDEN;
@@ -393,6 +408,10 @@ struct _script_ctx_t {
     DWORD last_match_index;
     DWORD last_match_length;
 
+    struct list objects;
+    unsigned object_cnt;
+    unsigned gc_threshold;
+
     jsdisp_t *global;
     jsdisp_t *function_constr;
     jsdisp_t *activex_constr;
@@ -1450,6 +1450,60 @@ function returnTest() {
 
 ok(returnTest() === undefined, "returnTest = " + returnTest());
 
+/* The same member expression evaluated on objects with different layouts */
+function getX(o) {
+    return o.x;
+}
+
+(function() {
+    var objs = [{x: 1, y: 2}, {y: 3, x: 4}, {z: 5}, {x: 6}], i, r = [];
+
+    for(i = 0; i < objs.length; i++)
+        r.push(getX(objs[i]));
+    ok(r.join() === "1,4,,6", "r = " + r.join());
+
+    delete objs[0].x;
+    ok(getX(objs[0]) === undefined, "getX(objs[0]) = " + getX(objs[0]));
+    objs[0].x = 7;
+    ok(getX(objs[0]) === 7, "getX(objs[0]) = " + getX(objs[0]));
+})();
+
+/* Identifiers shadowed after they were resolved once */
+var shadowTest = 1;
+
+function shadowFunc(shadow) {
+    var r = [], i;
+    for(i = 0; i < 2; i++) {
+        r.push(shadowTest);
+        if(shadow)
+            eval("var shadowTest = 2;");
+    }
+    return r.join();
+}
+
+ok(shadowFunc(false) === "1,1", "shadowFunc(false) = " + shadowFunc(false));
+ok(shadowFunc(true) === "1,2", "shadowFunc(true) = " + shadowFunc(true));
+
+/* CollectGarbage frees unreachable cycles, but not the objects still in use */
+(function() {
+    var obj = {x: [1,2,3]}, i;
+
+    function makeCycle() {
+        var o = {};
+        o.self = o;
+        o.func = function() { return o; };
+    }
+
+    obj.func = function() { return obj; };
+    for(i = 0; i < 10; i++)
+        makeCycle();
+
+    CollectGarbage();
+    ok(obj.func() === obj, "obj.func() !== obj");
+    ok(obj.x.length === 3, "obj.x.length = " + obj.x.length);
+    ok(obj.func().x[2] === 3, "obj.func().x[2] = " + obj.func().x[2]);
+})();
+
 /* Keep this test in the end of file */
 undefined = 6;
 ok(undefined === 6, "undefined = " + undefined);
@@ -660,4 +660,14 @@ tmp = new RegExp("abc/", "mgi");
 ok(tmp.toString() === "/abc//igm", "(new RegExp(\"abc/\")).toString() = " + tmp.toString());
 ok(/abc/.toString(1, false, "3") === "/abc/", "/abc/.toString(1, false, \"3\") = " + /abc/.toString());
 
+/* patterns starting with a literal */
+tmp = "xxabxxabcxab".replace(/abc?/g, "_");
+ok(tmp === "xx_xx_x_", "replace(/abc?/g) = " + tmp);
+tmp = /ab(c)/.exec("aabababc");
+ok(tmp.index === 5, "tmp.index = " + tmp.index);
+ok(tmp[1] === "c", "tmp[1] = " + tmp[1]);
+ok(/ab/.exec("aaaa") === null, "/ab/.exec(\"aaaa\") matched");
+ok("abcabc".search(/c/) === 2, "search(/c/) = " + "abcabc".search(/c/));
+ok("aAb".search(/ab/i) === 1, "search(/ab/i) = " + "aAb".search(/ab/i));
+
 reportSuccess();
@@ -47,6 +47,7 @@ struct msistring
     USHORT nonpersistent_refcount;
     WCHAR *data;
     int    len;
+    UINT   hash;
 };
 
 struct string_table
@@ -54,9 +55,10 @@ struct string_table
     UINT maxcount;         /* the number of strings */
     UINT freeslot;
     UINT codepage;
-    UINT sortcount;
+    UINT hashcount;            /* number of strings in the hash index */
+    UINT hashsize;             /* number of hash buckets, a power of 2 */
     struct msistring *strings; /* an array of strings */
-    UINT *sorted;              /* index */
+    UINT *hashtable;           /* open addressed index of string ids, 0 if empty */
 };
 
 static BOOL validate_codepage( UINT codepage )
@@ -69,6 +71,55 @@ static BOOL validate_codepage( UINT codepage )
     return TRUE;
 }
 
+static inline UINT hash_string( const WCHAR *str, int len )
+{
+    UINT hash = 0;
+
+    while (len--) hash = hash * 31 + *str++;
+    return hash;
+}
+
+static UINT get_hash_size( UINT count )
+{
+    UINT size = 16;
+
+    /* keep the load factor below 1/2 */
+    while (size < count * 2) size <<= 1;
+    return size;
+}
+
+static void hash_insert( string_table *st, UINT id )
+{
+    UINT mask = st->hashsize - 1, i = st->strings[id].hash & mask;
+
+    while (st->hashtable[i]) i = (i + 1) & mask;
+    st->hashtable[i] = id;
+    st->hashcount++;
+}
+
+static BOOL resize_hash( string_table *st, UINT count )
+{
+    UINT i, size = get_hash_size( count ), *table;
+
+    if (size <= st->hashsize) return TRUE;
+    if (!(table = msi_alloc_zero( size * sizeof(UINT) ))) return FALSE;
+
+    TRACE("resizing string hash to %u buckets\n", size);
+
+    msi_free( st->hashtable );
+    st->hashtable = table;
+    st->hashsize  = size;
+    st->hashcount = 0;
+
+    for (i = 1; i < st->maxcount; i++)
+    {
+        if (st->strings[i].data &&
+            (st->strings[i].persistent_refcount || st->strings[i].nonpersistent_refcount))
+            hash_insert( st, i );
+    }
+    return TRUE;
+}
+
 static string_table *init_stringtable( int entries, UINT codepage )
 {
     string_table *st;
@@ -89,8 +140,9 @@ static string_table *init_stringtable( int entries, UINT codepage )
         return NULL;    
     }
 
-    st->sorted = msi_alloc( sizeof (UINT) * entries );
-    if( !st->sorted )
+    st->hashsize = get_hash_size( entries );
+    st->hashtable = msi_alloc_zero( sizeof (UINT) * st->hashsize );
+    if( !st->hashtable )
     {
         msi_free( st->strings );
         msi_free( st );
@@ -100,7 +152,7 @@ static string_table *init_stringtable( int entries, UINT codepage )
     st->maxcount = entries;
     st->freeslot = 1;
     st->codepage = codepage;
-    st->sortcount = 0;
+    st->hashcount = 0;
 
     return st;
 }
@@ -116,13 +168,13 @@ VOID msi_destroy_stringtable( string_table *st )
             msi_free( st->strings[i].data );
     }
     msi_free( st->strings );
-    msi_free( st->sorted );
+    msi_free( st->hashtable );
     msi_free( st );
 }
 
 static int st_find_free_entry( string_table *st )
 {
-    UINT i, sz, *s;
+    UINT i, sz;
     struct msistring *p;
 
     TRACE("%p\n", st);
@@ -145,15 +197,7 @@ static int st_find_free_entry( string_table *st )
     if( !p )
         return -1;
 
-    s = msi_realloc( st->sorted, sz*sizeof(UINT) );
-    if( !s )
-    {
-        msi_free( p );
-        return -1;
-    }
-
     st->strings = p;
-    st->sorted = s;
 
     st->freeslot = st->maxcount;
     st->maxcount = sz;
@@ -163,54 +207,11 @@ static int st_find_free_entry( string_table *st )
     return st->freeslot;
 }
 
-static inline int cmp_string( const WCHAR *str1, int len1, const WCHAR *str2, int len2 )
-{
-    if (len1 < len2) return -1;
-    else if (len1 > len2) return 1;
-    while (len1)
-    {
-        if (*str1 == *str2) { str1++; str2++; }
-        else return *str1 - *str2;
-        len1--;
-    }
-    return 0;
-}
-
-static int find_insert_index( const string_table *st, UINT string_id )
-{
-    int i, c, low = 0, high = st->sortcount - 1;
-
-    while (low <= high)
-    {
-        i = (low + high) / 2;
-        c = cmp_string( st->strings[string_id].data, st->strings[string_id].len,
-                        st->strings[st->sorted[i]].data, st->strings[st->sorted[i]].len );
-        if (c < 0)
-            high = i - 1;
-        else if (c > 0)
-            low = i + 1;
-        else
-            return -1; /* already exists */
-    }
-    return high + 1;
-}
-
-static void insert_string_sorted( string_table *st, UINT string_id )
-{
-    int i;
-
-    i = find_insert_index( st, string_id );
-    if (i == -1)
-        return;
-
-    memmove( &st->sorted[i] + 1, &st->sorted[i], (st->sortcount - i) * sizeof(UINT) );
-    st->sorted[i] = string_id;
-    st->sortcount++;
-}
-
 static void set_st_entry( string_table *st, UINT n, WCHAR *str, int len, USHORT refcount,
                           enum StringPersistence persistence )
 {
+    BOOL hashed = resize_hash( st, st->hashcount + 1 );
+
     if (persistence == StringPersistent)
     {
         st->strings[n].persistent_refcount = refcount;
@@ -224,8 +225,12 @@ static void set_st_entry( string_table *st, UINT n, WCHAR *str, int len, USHORT
 
     st->strings[n].data = str;
     st->strings[n].len  = len;
+    st->strings[n].hash = hash_string( str, len );
 
-    insert_string_sorted( st, n );
+    if (hashed)
+        hash_insert( st, n );
+    else
+        ERR("failed to grow string hash\n");
 
     if( n < st->maxcount )
         st->freeslot = n + 1;
@@ -403,22 +408,19 @@ static UINT msi_id2stringA( const string_table *st, UINT id, LPSTR buffer, UINT
  */
 UINT msi_string2id( const string_table *st, const WCHAR *str, int len, UINT *id )
 {
-    int i, c, low = 0, high = st->sortcount - 1;
+    UINT hash, mask = st->hashsize - 1, i, n;
 
     if (len < 0) len = strlenW( str );
 
-    while (low <= high)
+    hash = hash_string( str, len );
+    for (i = hash & mask; (n = st->hashtable[i]); i = (i + 1) & mask)
     {
-        i = (low + high) / 2;
-        c = cmp_string( str, len, st->strings[st->sorted[i]].data, st->strings[st->sorted[i]].len );
+        const struct msistring *entry = &st->strings[n];
 
-        if (c < 0)
-            high = i - 1;
-        else if (c > 0)
-            low = i + 1;
-        else
+        if (entry->hash == hash && entry->len == len &&
+            !memcmp( entry->data, str, len * sizeof(WCHAR) ))
         {
-            *id = st->sorted[i];
+            *id = n;
             return ERROR_SUCCESS;
         }
     }
@@ -60,6 +60,7 @@ typedef struct tagMSICOLUMNINFO
     INT     ref_count;
     BOOL    temporary;
     MSICOLUMNHASHENTRY **hash_table;
+    UINT    hash_size;
 } MSICOLUMNINFO;
 
 struct tagMSITABLE
@@ -1171,6 +1172,17 @@ static UINT TABLE_fetch_stream( struct tagMSIVIEW *view, UINT row, UINT col, ISt
     return r;
 }
 
+static void free_hash_tables( MSITABLEVIEW *tv )
+{
+    UINT i;
+
+    for (i = 0; i < tv->num_cols; i++)
+    {
+        msi_free( tv->columns[i].hash_table );
+        tv->columns[i].hash_table = NULL;
+    }
+}
+
 static UINT TABLE_set_int( MSITABLEVIEW *tv, UINT row, UINT col, UINT val )
 {
     UINT offset, n, i;
@@ -1449,6 +1461,9 @@ static UINT table_create_new_row( struct tagMSIVIEW *view, UINT *num, BOOL tempo
 
     (*row_count)++;
 
+    /* the hash tables don't know about the new row */
+    free_hash_tables( tv );
+
     return ERROR_SUCCESS;
 }
 
@@ -1680,11 +1695,7 @@ static UINT TABLE_delete_row( struct tagMSIVIEW *view, UINT row )
     tv->table->row_count--;
 
     /* reset the hash tables */
-    for (i = 0; i < tv->num_cols; i++)
-    {
-        msi_free( tv->columns[i].hash_table );
-        tv->columns[i].hash_table = NULL;
-    }
+    free_hash_tables( tv );
 
     for (i = row + 1; i < num_rows; i++)
     {
@@ -1877,6 +1888,7 @@ static UINT TABLE_find_matching_rows( struct tagMSIVIEW *view, UINT col,
     {
         UINT i;
         UINT num_rows = tv->table->row_count;
+        UINT hash_size = MSITABLE_HASH_TABLE_SIZE;
         MSICOLUMNHASHENTRY **hash_table;
         MSICOLUMNHASHENTRY *new_entry;
 
@@ -1887,42 +1899,41 @@ static UINT TABLE_find_matching_rows( struct tagMSIVIEW *view, UINT col,
             return ERROR_FUNCTION_FAILED;
         }
 
+        /* keep the chains short for large tables */
+        while (hash_size < num_rows)
+            hash_size = hash_size * 2 + 1;
+
         /* allocate contiguous memory for the table and its entries so we
          * don't have to do an expensive cleanup */
-        hash_table = msi_alloc(MSITABLE_HASH_TABLE_SIZE * sizeof(MSICOLUMNHASHENTRY*) +
+        hash_table = msi_alloc(hash_size * sizeof(MSICOLUMNHASHENTRY*) +
             num_rows * sizeof(MSICOLUMNHASHENTRY));
         if (!hash_table)
             return ERROR_OUTOFMEMORY;
 
-        memset(hash_table, 0, MSITABLE_HASH_TABLE_SIZE * sizeof(MSICOLUMNHASHENTRY*));
+        memset(hash_table, 0, hash_size * sizeof(MSICOLUMNHASHENTRY*));
         tv->columns[col-1].hash_table = hash_table;
+        tv->columns[col-1].hash_size = hash_size;
 
-        new_entry = (MSICOLUMNHASHENTRY *)(hash_table + MSITABLE_HASH_TABLE_SIZE);
+        new_entry = (MSICOLUMNHASHENTRY *)(hash_table + hash_size) + num_rows;
 
-        for (i = 0; i < num_rows; i++, new_entry++)
+        /* insert the rows backwards, so that each chain is in row order */
+        for (i = num_rows; i > 0; i--)
         {
             UINT row_value;
 
-            if (view->ops->fetch_int( view, i, col, &row_value ) != ERROR_SUCCESS)
+            if (view->ops->fetch_int( view, i - 1, col, &row_value ) != ERROR_SUCCESS)
                 continue;
 
-            new_entry->next = NULL;
+            new_entry--;
             new_entry->value = row_value;
-            new_entry->row = i;
-            if (hash_table[row_value % MSITABLE_HASH_TABLE_SIZE])
-            {
-                MSICOLUMNHASHENTRY *prev_entry = hash_table[row_value % MSITABLE_HASH_TABLE_SIZE];
-                while (prev_entry->next)
-                    prev_entry = prev_entry->next;
-                prev_entry->next = new_entry;
-            }
-            else
-                hash_table[row_value % MSITABLE_HASH_TABLE_SIZE] = new_entry;
+            new_entry->row = i - 1;
+            new_entry->next = hash_table[row_value % hash_size];
+            hash_table[row_value % hash_size] = new_entry;
         }
     }
 
     if( !*handle )
-        entry = tv->columns[col-1].hash_table[val % MSITABLE_HASH_TABLE_SIZE];
+        entry = tv->columns[col-1].hash_table[val % tv->columns[col-1].hash_size];
     else
         entry = (*handle)->next;
 
@@ -2083,6 +2083,54 @@ static void test_where(void)
     MsiViewClose(view);
     MsiCloseHandle(view);
 
+    rec = MsiCreateRecord(1);
+    MsiRecordSetInteger(rec, 1, 2);
+
+    query = "SELECT * FROM `Media` WHERE `DiskId` = ?";
+    r = MsiDatabaseOpenViewA(hdb, query, &view);
+    ok(r == ERROR_SUCCESS, "Expected ERROR_SUCCESS, got %d\n", r);
+    r = MsiViewExecute(view, rec);
+    ok(r == ERROR_SUCCESS, "Expected ERROR_SUCCESS, got %d\n", r);
+
+    MsiCloseHandle(rec);
+
+    r = MsiViewFetch(view, &rec);
+    ok(r == ERROR_SUCCESS, "Expected ERROR_SUCCESS, got %d\n", r);
+    ok( check_record( rec, 4, "one.cab"), "wrong cabinet\n");
+    MsiCloseHandle(rec);
+
+    r = MsiViewFetch(view, &rec);
+    ok(r == ERROR_NO_MORE_ITEMS, "Expected ERROR_NO_MORE_ITEMS, got %d\n", r);
+
+    MsiViewClose(view);
+    MsiCloseHandle(view);
+
+    rec = 0;
+    query = "SELECT * FROM `Media` WHERE `Cabinet` = 'two.cab' AND `LastSequence` = 2";
+    r = do_query(hdb, query, &rec);
+    ok( r == ERROR_SUCCESS, "query failed: %d\n", r );
+    ok( MsiRecordGetInteger(rec, 1) == 3, "got %d\n", MsiRecordGetInteger(rec, 1) );
+    MsiCloseHandle( rec );
+
+    rec = 0;
+    query = "SELECT * FROM `Media` WHERE `Cabinet` = 'missing.cab'";
+    r = do_query(hdb, query, &rec);
+    ok( r == ERROR_NO_MORE_ITEMS, "query failed: %d\n", r );
+    MsiCloseHandle( rec );
+
+    /* rows added after a lookup must be found too */
+    r = run_query( hdb, 0, "INSERT INTO `Media` "
+            "( `DiskId`, `LastSequence`, `DiskPrompt`, `Cabinet`, `VolumeLabel`, `Source` ) "
+            "VALUES ( 4, -1, '', 'three.cab', '', '' )" );
+    ok( r == S_OK, "cannot add file to the Media table: %d\n", r );
+
+    rec = 0;
+    query = "SELECT * FROM `Media` WHERE `LastSequence` = -1";
+    r = do_query(hdb, query, &rec);
+    ok( r == ERROR_SUCCESS, "query failed: %d\n", r );
+    ok( check_record( rec, 4, "three.cab"), "wrong cabinet\n");
+    MsiCloseHandle( rec );
+
     MsiCloseHandle( hdb );
     DeleteFileA(msifile);
 }
@@ -52,6 +52,7 @@ typedef struct tagJOINTABLE
     UINT col_count;
     UINT row_count;
     UINT table_index;
+    BOOL indexed; /* find_matching_rows can be used to look up rows */
 } JOINTABLE;
 
 typedef struct tagMSIORDERINFO
@@ -599,38 +600,213 @@ static UINT WHERE_evaluate( MSIWHEREVIEW *wv, const UINT rows[],
     return ERROR_SUCCESS;
 }
 
+static UINT count_wildcards( const struct expr *expr )
+{
+    switch (expr->type)
+    {
+    case EXPR_WILDCARD:
+        return 1;
+    case EXPR_COMPLEX:
+    case EXPR_STRCMP:
+        return count_wildcards( expr->u.expr.left ) + count_wildcards( expr->u.expr.right );
+    default:
+        return 0;
+    }
+}
+
+static inline BOOL is_table_column( const struct expr *expr, const JOINTABLE *table )
+{
+    return (expr->type == EXPR_COL_NUMBER || expr->type == EXPR_COL_NUMBER32 ||
+            expr->type == EXPR_COL_NUMBER_STRING) && expr->u.column.parsed.table == table;
+}
+
+/* gets the value of an integer expression that doesn't depend on the table being enumerated */
+static BOOL get_known_int( const struct expr *expr, const UINT rows[], MSIRECORD *record,
+                           UINT rec_index, INT *val )
+{
+    UINT tval;
+
+    switch (expr->type)
+    {
+    case EXPR_UVAL:
+        *val = expr->u.uval;
+        return TRUE;
+
+    case EXPR_WILDCARD:
+        if (!record)
+            return FALSE;
+        *val = MSI_RecordGetInteger( record, rec_index );
+        return TRUE;
+
+    case EXPR_COL_NUMBER:
+    case EXPR_COL_NUMBER32:
+        if (expr_fetch_value( &expr->u.column, rows, &tval ) != ERROR_SUCCESS)
+            return FALSE;
+        *val = tval - (expr->type == EXPR_COL_NUMBER ? 0x8000 : 0x80000000);
+        return TRUE;
+
+    default:
+        return FALSE;
+    }
+}
+
+/* gets the string id of a string expression that doesn't depend on the table being enumerated */
+static BOOL get_known_string( MSIWHEREVIEW *wv, const struct expr *expr, const UINT rows[],
+                              MSIRECORD *record, UINT rec_index, UINT *id, BOOL *no_match )
+{
+    const WCHAR *str;
+
+    switch (expr->type)
+    {
+    case EXPR_SVAL:
+        str = expr->u.sval;
+        break;
+
+    case EXPR_WILDCARD:
+        if (!record)
+            return FALSE;
+        str = MSI_RecordGetString( record, rec_index );
+        break;
+
+    case EXPR_COL_NUMBER_STRING:
+        if (expr_fetch_value( &expr->u.column, rows, id ) != ERROR_SUCCESS)
+            return FALSE;
+        str = msi_string_lookup( wv->db->strings, *id, NULL );
+        return str && *str;
+
+    default:
+        return FALSE;
+    }
+
+    /* null and empty strings compare equal, leave them to the full scan */
+    if (!str || !*str)
+        return FALSE;
+
+    if (msi_string2id( wv->db->strings, str, -1, id ) != ERROR_SUCCESS)
+        *no_match = TRUE;
+    return TRUE;
+}
+
+/* Looks for an equality between a column of the table and a value that is known
+ * before its rows are enumerated, so that matching rows can be looked up instead
+ * of scanning the whole table.  Only conditions that are AND-ed together are
+ * considered, since they must all hold for a row to be selected. */
+static BOOL find_index_expr( MSIWHEREVIEW *wv, const struct expr *cond, const JOINTABLE *table,
+                             const UINT rows[], MSIRECORD *record, UINT rec_index,
+                             UINT *col, UINT *val, BOOL *no_match )
+{
+    const struct expr *column, *other;
+    INT ival;
+
+    if (cond->type != EXPR_COMPLEX && cond->type != EXPR_STRCMP)
+        return FALSE;
+
+    if (cond->type == EXPR_COMPLEX && cond->u.expr.op == OP_AND)
+        return find_index_expr( wv, cond->u.expr.left, table, rows, record, rec_index,
+                                col, val, no_match ) ||
+               find_index_expr( wv, cond->u.expr.right, table, rows, record,
+                                rec_index + count_wildcards( cond->u.expr.left ), col, val, no_match );
+
+    if (cond->u.expr.op != OP_EQ)
+        return FALSE;
+
+    if (is_table_column( cond->u.expr.left, table ))
+    {
+        column = cond->u.expr.left;
+        other = cond->u.expr.right;
+    }
+    else if (is_table_column( cond->u.expr.right, table ))
+    {
+        column = cond->u.expr.right;
+        other = cond->u.expr.left;
+    }
+    else
+        return FALSE;
+
+    /* the column side has no wildcards, so a wildcard on the other side is the next one */
+    if (column->type == EXPR_COL_NUMBER_STRING)
+    {
+        if (cond->type != EXPR_STRCMP ||
+            !get_known_string( wv, other, rows, record, rec_index + 1, val, no_match ))
+            return FALSE;
+    }
+    else
+    {
+        if (cond->type != EXPR_COMPLEX || !get_known_int( other, rows, record, rec_index + 1, &ival ))
+            return FALSE;
+        *val = ival + (column->type == EXPR_COL_NUMBER ? 0x8000 : 0x80000000);
+    }
+
+    *col = column->u.column.parsed.column;
+    return TRUE;
+}
+
+static UINT check_condition( MSIWHEREVIEW *wv, MSIRECORD *record, JOINTABLE **tables,
+                             UINT table_rows[] );
+
+static UINT check_row( MSIWHEREVIEW *wv, MSIRECORD *record, JOINTABLE **tables,
+                       UINT table_rows[] )
+{
+    UINT r;
+    INT val = 0;
+
+    wv->rec_index = 0;
+    r = WHERE_evaluate( wv, table_rows, wv->cond, &val, record );
+    if (r != ERROR_SUCCESS && r != ERROR_CONTINUE)
+        return r;
+    if (!val)
+        return ERROR_SUCCESS;
+
+    if (*(tables + 1))
+        return check_condition(wv, record, tables + 1, table_rows);
+
+    if (r != ERROR_SUCCESS)
+        return r;
+    add_row (wv, table_rows);
+    return ERROR_SUCCESS;
+}
+
 static UINT check_condition( MSIWHEREVIEW *wv, MSIRECORD *record, JOINTABLE **tables,
                              UINT table_rows[] )
 {
-    UINT r = ERROR_FUNCTION_FAILED;
-    INT val;
+    JOINTABLE *table = *tables;
+    UINT r = ERROR_SUCCESS, col, val;
+    BOOL no_match = FALSE;
 
-    for (table_rows[(*tables)->table_index] = 0;
-         table_rows[(*tables)->table_index] < (*tables)->row_count;
-         table_rows[(*tables)->table_index]++)
+    if (table->indexed && wv->cond &&
+        find_index_expr( wv, wv->cond, table, table_rows, record, 0, &col, &val, &no_match ))
     {
-        val = 0;
-        wv->rec_index = 0;
-        r = WHERE_evaluate( wv, table_rows, wv->cond, &val, record );
-        if (r != ERROR_SUCCESS && r != ERROR_CONTINUE)
-            break;
-        if (val)
+        MSIITERHANDLE handle = NULL;
+        UINT row;
+
+        TRACE("looking up rows of table %u with column %u = %08x\n", table->table_index, col, val);
+
+        if (!no_match)
         {
-            if (*(tables + 1))
+            while ((r = table->view->ops->find_matching_rows( table->view, col, val, &row,
+                                                              &handle )) == ERROR_SUCCESS)
             {
-                r = check_condition(wv, record, tables + 1, table_rows);
+                table_rows[table->table_index] = row;
+                r = check_row( wv, record, tables, table_rows );
                 if (r != ERROR_SUCCESS)
                     break;
             }
-            else
-            {
-                if (r != ERROR_SUCCESS)
-                    break;
-                add_row (wv, table_rows);
-            }
+            if (r == ERROR_NO_MORE_ITEMS)
+                r = ERROR_SUCCESS;
+        }
+    }
+    else
+    {
+        for (table_rows[table->table_index] = 0;
+             table_rows[table->table_index] < table->row_count;
+             table_rows[table->table_index]++)
+        {
+            r = check_row( wv, record, tables, table_rows );
+            if (r != ERROR_SUCCESS)
+                break;
         }
     }
-    table_rows[(*tables)->table_index] = INVALID_ROW_INDEX;
+    table_rows[table->table_index] = INVALID_ROW_INDEX;
     return r;
 }
 
@@ -1260,6 +1436,7 @@ UINT WHERE_CreateView( MSIDATABASE *db, MSIVIEW **view, LPWSTR tables,
 
         wv->col_count += table->col_count;
         table->table_index = wv->table_count++;
+        table->indexed = strcmpW(tables, szStreams) && strcmpW(tables, szStorages);
 
         table->next = wv->tables;
         wv->tables = table;
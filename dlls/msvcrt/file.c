@@ -2585,15 +2585,33 @@ static int read_i(int fd, void *buf, unsigned int count)
         }
         else if (fdinfo->wxflag & WX_TEXT)
         {
-            DWORD i, j;
+            DWORD i, j, run_end = num_read;
 
             if (bufstart[0]=='\n' && (!utf16 || bufstart[1]==0))
                 fdinfo->wxflag |= WX_READNL;
             else
                 fdinfo->wxflag &= ~WX_READNL;
 
+            if (!utf16)
+            {
+                char *eof = memchr(bufstart, 0x1a, num_read);
+                if (eof) run_end = eof - bufstart;
+            }
+
             for (i=0, j=0; i<num_read; i+=1+utf16)
             {
+                /* move runs of characters that need no translation at once */
+                if (!utf16 && i<run_end && bufstart[i]!='\r')
+                {
+                    char *cr = memchr(bufstart+i, '\r', run_end-i);
+                    DWORD run = (cr ? cr-bufstart : run_end) - i;
+
+                    if (i != j) memmove(bufstart+j, bufstart+i, run);
+                    j += run;
+                    i += run-1;
+                    continue;
+                }
+
                 /* in text mode, a ctrl-z signals EOF */
                 if (bufstart[i]==0x1a && (!utf16 || bufstart[i+1]==0))
                 {
@@ -3214,21 +3232,25 @@ int CDECL MSVCRT__write(int fd, const void* buf, unsigned int count)
 
         if (!(info->exflag & (EF_UTF8|EF_UTF16)))
         {
+            const char *r, *lf, *end = s + count;
+
             /* find number of \n */
-            for (nr_lf=0, i=0; i<count; i++)
-                if (s[i] == '\n')
-                    nr_lf++;
+            for (nr_lf=0, lf=s; (lf = memchr(lf, '\n', end-lf)); lf++)
+                nr_lf++;
             if (nr_lf)
             {
                 size = count+nr_lf;
                 if ((q = p = MSVCRT_malloc(size)))
                 {
-                    for (s = buf, i = 0, j = 0; i < count; i++)
+                    /* copy the runs between line feeds in bulk */
+                    for (r = buf, j = 0; (lf = memchr(r, '\n', end-r)); r = lf+1)
                     {
-                        if (s[i] == '\n')
-                            p[j++] = '\r';
-                        p[j++] = s[i];
+                        memcpy(p+j, r, lf-r);
+                        j += lf-r;
+                        p[j++] = '\r';
+                        p[j++] = '\n';
                     }
+                    memcpy(p+j, r, end-r);
                 }
                 else
                 {
@@ -3491,19 +3513,39 @@ char * CDECL MSVCRT_fgets(char *s, int size, MSVCRT_FILE* file)
 
   MSVCRT__lock_file(file);
 
-  while ((size >1) && (cc = MSVCRT_fgetc(file)) != MSVCRT_EOF && cc != '\n')
+  while (size > 1)
+  {
+    if (file->_cnt > 0)
     {
-      *s++ = (char)cc;
-      size --;
+      /* copy directly from the stream buffer up to the next newline */
+      int len = min(file->_cnt, size - 1);
+      char *nl = memchr(file->_ptr, '\n', len);
+
+      if (nl)
+        len = nl - file->_ptr + 1;
+      memcpy(s, file->_ptr, len);
+      file->_ptr += len;
+      file->_cnt -= len;
+      s += len;
+      size -= len;
+      if (nl)
+        break;
+      continue;
     }
+
+    if ((cc = MSVCRT__filbuf(file)) == MSVCRT_EOF)
+      break;
+    *s++ = (char)cc;
+    size--;
+    if (cc == '\n')
+      break;
+  }
   if ((cc == MSVCRT_EOF) && (s == buf_start)) /* If nothing read, return 0*/
   {
     TRACE(":nothing read\n");
     MSVCRT__unlock_file(file);
     return NULL;
   }
-  if ((cc != MSVCRT_EOF) && (size > 1))
-    *s++ = cc;
   *s = '\0';
   TRACE(":got %s\n", debugstr_a(buf_start));
   MSVCRT__unlock_file(file);
@@ -4617,57 +4659,172 @@ static int puts_clbk_file_w(void *file, int len, const MSVCRT_wchar_t *str)
     return len;
 }
 
-/*********************************************************************
- *		vfprintf (MSVCRT.@)
- */
-int CDECL MSVCRT_vfprintf(MSVCRT_FILE* file, const char *format, __ms_va_list valist)
+/* The formatting engine emits output in many small pieces (literal text,
+ * padding, converted arguments). Collect them in a local buffer so the FILE
+ * is only written to once per buffer-full instead of once per piece. */
+#define PRINTF_FILE_BUFSIZE 512
+
+struct printf_file_ctx_a {
+    MSVCRT_FILE *file;
+    int len;
+    int lost;
+    BOOL error;
+    char buf[PRINTF_FILE_BUFSIZE];
+};
+
+struct printf_file_ctx_w {
+    MSVCRT_FILE *file;
+    int len;
+    int lost;
+    BOOL error;
+    MSVCRT_wchar_t buf[PRINTF_FILE_BUFSIZE];
+};
+
+static void printf_file_write_a(struct printf_file_ctx_a *ctx, int len, const char *str)
+{
+    int ret = puts_clbk_file_a(ctx->file, len, str);
+
+    if(ret < 0) ctx->error = TRUE;
+    else ctx->lost += len - ret;
+}
+
+static void printf_file_flush_a(struct printf_file_ctx_a *ctx)
+{
+    if(!ctx->len)
+        return;
+
+    printf_file_write_a(ctx, ctx->len, ctx->buf);
+    ctx->len = 0;
+}
+
+static int puts_clbk_file_buffered_a(void *ctx, int len, const char *str)
+{
+    struct printf_file_ctx_a *out = ctx;
+
+    if(out->len + len > PRINTF_FILE_BUFSIZE) {
+        printf_file_flush_a(out);
+        if(len > PRINTF_FILE_BUFSIZE)
+            printf_file_write_a(out, len, str);
+        if(out->error)
+            return -1;
+        if(len > PRINTF_FILE_BUFSIZE)
+            return len;
+    }
+
+    memcpy(out->buf + out->len, str, len);
+    out->len += len;
+    return len;
+}
+
+static void printf_file_write_w(struct printf_file_ctx_w *ctx, int len, const MSVCRT_wchar_t *str)
+{
+    int ret = puts_clbk_file_w(ctx->file, len, str);
+
+    /* text mode streams fail with -1, like the unbuffered callback did */
+    if(ret < 0) ctx->error = TRUE;
+    else ctx->lost += len - ret;
+}
+
+static void printf_file_flush_w(struct printf_file_ctx_w *ctx)
+{
+    if(!ctx->len)
+        return;
+
+    printf_file_write_w(ctx, ctx->len, ctx->buf);
+    ctx->len = 0;
+}
+
+static int puts_clbk_file_buffered_w(void *ctx, int len, const MSVCRT_wchar_t *str)
+{
+    struct printf_file_ctx_w *out = ctx;
+
+    if(out->len + len > PRINTF_FILE_BUFSIZE) {
+        printf_file_flush_w(out);
+        if(len > PRINTF_FILE_BUFSIZE)
+            printf_file_write_w(out, len, str);
+        if(out->error)
+            return -1;
+        if(len > PRINTF_FILE_BUFSIZE)
+            return len;
+    }
+
+    memcpy(out->buf + out->len, str, len*sizeof(MSVCRT_wchar_t));
+    out->len += len;
+    return len;
+}
+
+static int vfprintf_helper_a(MSVCRT_FILE *file, const char *format, MSVCRT__locale_t locale,
+        BOOL invoke_invalid_param_handler, __ms_va_list valist)
 {
+    struct printf_file_ctx_a ctx;
     BOOL tmp_buf;
     int ret;
 
+    ctx.file = file;
+    ctx.len = 0;
+    ctx.lost = 0;
+    ctx.error = FALSE;
+
     MSVCRT__lock_file(file);
     tmp_buf = add_std_buffer(file);
-    ret = pf_printf_a(puts_clbk_file_a, file, format, NULL, FALSE, FALSE, arg_clbk_valist, NULL, &valist);
+    ret = pf_printf_a(puts_clbk_file_buffered_a, &ctx, format, locale, FALSE,
+            invoke_invalid_param_handler, arg_clbk_valist, NULL, &valist);
+    printf_file_flush_a(&ctx);
     if(tmp_buf) remove_std_buffer(file);
     MSVCRT__unlock_file(file);
 
-    return ret;
+    if(ctx.error) return -1;
+    return ret < 0 ? ret : ret - ctx.lost;
 }
 
-/*********************************************************************
- *		vfprintf_s (MSVCRT.@)
- */
-int CDECL MSVCRT_vfprintf_s(MSVCRT_FILE* file, const char *format, __ms_va_list valist)
+static int vfprintf_helper_w(MSVCRT_FILE *file, const MSVCRT_wchar_t *format, MSVCRT__locale_t locale,
+        BOOL invoke_invalid_param_handler, __ms_va_list valist)
 {
+    struct printf_file_ctx_w ctx;
     BOOL tmp_buf;
     int ret;
 
-    if(!MSVCRT_CHECK_PMT(file != NULL)) return -1;
+    ctx.file = file;
+    ctx.len = 0;
+    ctx.lost = 0;
+    ctx.error = FALSE;
 
     MSVCRT__lock_file(file);
     tmp_buf = add_std_buffer(file);
-    ret = pf_printf_a(puts_clbk_file_a, file, format, NULL, FALSE, TRUE, arg_clbk_valist, NULL, &valist);
+    ret = pf_printf_w(puts_clbk_file_buffered_w, &ctx, format, locale, FALSE,
+            invoke_invalid_param_handler, arg_clbk_valist, NULL, &valist);
+    printf_file_flush_w(&ctx);
     if(tmp_buf) remove_std_buffer(file);
     MSVCRT__unlock_file(file);
 
-    return ret;
+    if(ctx.error) return -1;
+    return ret < 0 ? ret : ret - ctx.lost;
 }
 
 /*********************************************************************
- *		vfwprintf (MSVCRT.@)
+ *		vfprintf (MSVCRT.@)
  */
-int CDECL MSVCRT_vfwprintf(MSVCRT_FILE* file, const MSVCRT_wchar_t *format, __ms_va_list valist)
+int CDECL MSVCRT_vfprintf(MSVCRT_FILE* file, const char *format, __ms_va_list valist)
 {
-    BOOL tmp_buf;
-    int ret;
+    return vfprintf_helper_a(file, format, NULL, FALSE, valist);
+}
 
-    MSVCRT__lock_file(file);
-    tmp_buf = add_std_buffer(file);
-    ret = pf_printf_w(puts_clbk_file_w, file, format, NULL, FALSE, FALSE, arg_clbk_valist, NULL, &valist);
-    if(tmp_buf) remove_std_buffer(file);
-    MSVCRT__unlock_file(file);
+/*********************************************************************
+ *		vfprintf_s (MSVCRT.@)
+ */
+int CDECL MSVCRT_vfprintf_s(MSVCRT_FILE* file, const char *format, __ms_va_list valist)
+{
+    if(!MSVCRT_CHECK_PMT(file != NULL)) return -1;
 
-    return ret;
+    return vfprintf_helper_a(file, format, NULL, TRUE, valist);
+}
+
+/*********************************************************************
+ *		vfwprintf (MSVCRT.@)
+ */
+int CDECL MSVCRT_vfwprintf(MSVCRT_FILE* file, const MSVCRT_wchar_t *format, __ms_va_list valist)
+{
+    return vfprintf_helper_w(file, format, NULL, FALSE, valist);
 }
 
 /*********************************************************************
@@ -4675,18 +4832,9 @@ int CDECL MSVCRT_vfwprintf(MSVCRT_FILE* file, const MSVCRT_wchar_t *format, __ms
  */
 int CDECL MSVCRT_vfwprintf_s(MSVCRT_FILE* file, const MSVCRT_wchar_t *format, __ms_va_list valist)
 {
-    BOOL tmp_buf;
-    int ret;
-
     if (!MSVCRT_CHECK_PMT( file != NULL )) return -1;
 
-    MSVCRT__lock_file(file);
-    tmp_buf = add_std_buffer(file);
-    ret = pf_printf_w(puts_clbk_file_w, file, format, NULL, FALSE, TRUE, arg_clbk_valist, NULL, &valist);
-    if(tmp_buf) remove_std_buffer(file);
-    MSVCRT__unlock_file(file);
-
-    return ret;
+    return vfprintf_helper_w(file, format, NULL, TRUE, valist);
 }
 
 /*********************************************************************
@@ -4695,18 +4843,9 @@ int CDECL MSVCRT_vfwprintf_s(MSVCRT_FILE* file, const MSVCRT_wchar_t *format, __
 int CDECL MSVCRT__vfwprintf_l(MSVCRT_FILE* file, const MSVCRT_wchar_t *format,
         MSVCRT__locale_t locale, __ms_va_list valist)
 {
-    BOOL tmp_buf;
-    int ret;
-
     if (!MSVCRT_CHECK_PMT( file != NULL )) return -1;
 
-    MSVCRT__lock_file(file);
-    tmp_buf = add_std_buffer(file);
-    ret = pf_printf_w(puts_clbk_file_w, file, format, locale, FALSE, FALSE, arg_clbk_valist, NULL, &valist);
-    if(tmp_buf) remove_std_buffer(file);
-    MSVCRT__unlock_file(file);
-
-    return ret;
+    return vfprintf_helper_w(file, format, locale, FALSE, valist);
 }
 
 /*********************************************************************
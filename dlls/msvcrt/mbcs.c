@@ -569,10 +569,15 @@ unsigned char* CDECL _mbsninc(const unsigned char* str, MSVCRT_size_t num)
  */
 MSVCRT_size_t CDECL _mbslen(const unsigned char* str)
 {
+  MSVCRT_pthreadmbcinfo mbcinfo = get_mbcinfo();
   MSVCRT_size_t len = 0;
+
+  if(!mbcinfo->ismbcodepage)
+    return u_strlen(str); /* ASCII CP */
+
   while(*str)
   {
-    if (_ismbblead(*str))
+    if (mbcinfo->mbctype[*str + 1] & _M1)
     {
       str++;
       if (!*str)  /* count only full chars */
@@ -1551,13 +1556,14 @@ unsigned char* CDECL _mbsnset(unsigned char* str, unsigned int c, MSVCRT_size_t
  */
 MSVCRT_size_t CDECL _mbsnccnt(const unsigned char* str, MSVCRT_size_t len)
 {
+  MSVCRT_pthreadmbcinfo mbcinfo = get_mbcinfo();
   MSVCRT_size_t ret;
-  if(get_mbcinfo()->ismbcodepage)
+  if(mbcinfo->ismbcodepage)
   {
     ret=0;
     while(*str && len-- > 0)
     {
-      if(_ismbblead(*str))
+      if(mbcinfo->mbctype[*str + 1] & _M1)
       {
         if (!len)
           break;
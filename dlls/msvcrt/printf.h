@@ -89,15 +89,16 @@ static inline int FUNC_NAME(pf_fill)(FUNC_NAME(puts_clbk) pf_puts, void *puts_ct
     written = r;
 
     if((!left && flags->LeftAlign) || (left && !flags->LeftAlign)) {
-        APICHAR ch;
+        APICHAR pad[16];
+        int cnt;
 
-        if(left && flags->PadZero)
-            ch = '0';
-        else
-            ch = ' ';
+        for(i=0; i<sizeof(pad)/sizeof(pad[0]); i++)
+            pad[i] = (left && flags->PadZero) ? '0' : ' ';
 
-        for(i=0; i<flags->FieldLength-len && r>=0; i++) {
-            r = pf_puts(puts_ctx, 1, &ch);
+        /* output the padding in chunks instead of one character at a time */
+        for(i=flags->FieldLength-len; i>0 && r>=0; i-=cnt) {
+            cnt = min(i, (int)(sizeof(pad)/sizeof(pad[0])));
+            r = pf_puts(puts_ctx, cnt, pad);
             written += r;
         }
     }
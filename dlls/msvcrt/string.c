@@ -1713,9 +1713,13 @@ int __cdecl MSVCRT__strnicmp_l(const char *s1, const char *s2,
     if(!locinfo->lc_handle[MSVCRT_LC_CTYPE])
         return strncasecmp(s1, s2, count);
 
+    /* Use the case map directly for ASCII characters, _tolower_l() is only
+     * needed for the ones that may be part of a multibyte character. */
     do {
-        c1 = MSVCRT__tolower_l(*s1++, locale);
-        c2 = MSVCRT__tolower_l(*s2++, locale);
+        c1 = *s1++;
+        c2 = *s2++;
+        c1 = (unsigned char)c1 < 0x80 ? locinfo->pclmap[(unsigned char)c1] : MSVCRT__tolower_l(c1, locale);
+        c2 = (unsigned char)c2 < 0x80 ? locinfo->pclmap[(unsigned char)c2] : MSVCRT__tolower_l(c2, locale);
     }while(--count && c1 && c1==c2);
 
     return c1-c2;
@@ -765,6 +765,7 @@ static void test_fprintf(void)
 {
     static const char file_name[] = "fprintf.tst";
     static const WCHAR utf16_test[] = {'u','n','i','c','o','d','e','\n',0};
+    static const WCHAR long_test[] = {'%','*','d',0};
 
     FILE *fp = fopen(file_name, "wb");
     char buf[1024];
@@ -844,6 +845,30 @@ static void test_fprintf(void)
     ok(ret == 37, "ret =  %d\n", ret);
     ok(!strcmp(buf, "unicode\r\n"), "buf = %s\n", buf);
 
+    fclose(fp);
+
+    /* output longer than the internal formatting buffer */
+    fp = fopen(file_name, "wb");
+    ret = fprintf(fp, "%s%*d%s", "start", 1000, 1, "end");
+    ok(ret == 1008, "ret = %d\n", ret);
+    ret = ftell(fp);
+    ok(ret == 1008, "ftell returned %d\n", ret);
+    fclose(fp);
+
+    fp = fopen(file_name, "rb");
+    memset(buf, 0, sizeof(buf));
+    ret = fread(buf, 1, sizeof(buf), fp);
+    ok(ret == 1008, "fread returned %d\n", ret);
+    ok(!memcmp(buf, "start    ", 9), "buf = %s\n", buf);
+    ok(!memcmp(buf + 1003, "1end", 4), "buf = %s\n", buf + 1003);
+    fclose(fp);
+
+    /* writing to a read-only text mode stream fails */
+    fp = fopen(file_name, "rt");
+    ret = fwprintf(fp, utf16_test);
+    ok(ret == -1, "ret = %d\n", ret);
+    ret = fwprintf(fp, long_test, 1000, 1);
+    ok(ret == -1, "ret = %d\n", ret);
     fclose(fp);
     unlink(file_name);
 }
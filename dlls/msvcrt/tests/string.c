@@ -2649,6 +2649,43 @@ static void test_strncpy(void)
     ok(!strncmp(dst, "0123456789", TEST_STRNCPY_LEN), "dst != 0123456789\n");
 }
 
+static void test_wcslen_wcschr(void)
+{
+    wchar_t buf[80], *ret;
+    int len, start, i;
+
+    /* The strings are scanned a word at a time, check all start alignments
+     * and lengths around the word boundaries. */
+    for (start = 0; start < 8; start++)
+    {
+        for (len = 0; len < 40; len++)
+        {
+            for (i = 0; i < sizeof(buf) / sizeof(buf[0]); i++)
+                buf[i] = 0x8000 | i;
+            for (i = 0; i < len; i++)
+                buf[start + i] = (i & 1) ? 0x101 : 0xffff;
+            buf[start + len] = 0;
+
+            ok(wcslen(buf + start) == len, "start %d: wcslen returned %d, expected %d\n",
+                    start, (int)wcslen(buf + start), len);
+
+            ret = wcschr(buf + start, 0);
+            ok(ret == buf + start + len, "start %d, len %d: wcschr(0) returned %p, expected %p\n",
+                    start, len, ret, buf + start + len);
+            ret = wcschr(buf + start, 0x8000 | (start + len + 1));
+            ok(!ret, "start %d, len %d: wcschr returned %p for a character past the end\n",
+                    start, len, ret);
+            if (len)
+            {
+                buf[start + len - 1] = 'x';
+                ret = wcschr(buf + start, 'x');
+                ok(ret == buf + start + len - 1, "start %d, len %d: wcschr returned %p, expected %p\n",
+                        start, len, ret, buf + start + len - 1);
+            }
+        }
+    }
+}
+
 START_TEST(string)
 {
     char mem[100];
@@ -2745,6 +2782,7 @@ START_TEST(string)
     test_wctomb();
     test__atodbl();
     test__stricmp();
+    test_wcslen_wcschr();
     test__wcstoi64();
     test_atoi();
     test_strncpy();
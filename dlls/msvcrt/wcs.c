@@ -1988,12 +1988,35 @@ int CDECL MSVCRT_towlower(MSVCRT_wint_t c)
     return MSVCRT__towlower_l(c, NULL);
 }
 
+/* Helpers for scanning a machine word worth of characters at once. A word
+ * has a zero character if any of its 16-bit lanes borrows when one is
+ * subtracted from it. Aligned words never cross a page boundary, so reading
+ * a whole word past the terminator is safe. */
+#define WCS_WORD_LOW    (~(ULONG_PTR)0 / 0xffff)
+#define WCS_WORD_HIGH   (WCS_WORD_LOW << 15)
+#define WCS_WORD_HAS_ZERO(w) (((w) - WCS_WORD_LOW) & ~(w) & WCS_WORD_HIGH)
+
 /*********************************************************************
  *              wcschr (MSVCRT.@)
  */
 MSVCRT_wchar_t* CDECL MSVCRT_wcschr(const MSVCRT_wchar_t *str, MSVCRT_wchar_t ch)
 {
-    return strchrW(str, ch);
+    ULONG_PTR pattern = WCS_WORD_LOW * ch;
+    const ULONG_PTR *word;
+
+    if ((ULONG_PTR)str & 1)
+        return strchrW(str, ch);
+
+    for (; (ULONG_PTR)str & (sizeof(ULONG_PTR) - 1); str++)
+    {
+        if (*str == ch) return (MSVCRT_wchar_t *)str;
+        if (!*str) return NULL;
+    }
+
+    for (word = (const ULONG_PTR *)str; !WCS_WORD_HAS_ZERO(*word)
+            && !WCS_WORD_HAS_ZERO(*word ^ pattern); word++);
+
+    return strchrW((const MSVCRT_wchar_t *)word, ch);
 }
 
 /***********************************************************************
@@ -2001,7 +2024,19 @@ MSVCRT_wchar_t* CDECL MSVCRT_wcschr(const MSVCRT_wchar_t *str, MSVCRT_wchar_t ch
  */
 int CDECL MSVCRT_wcslen(const MSVCRT_wchar_t *str)
 {
-    return strlenW(str);
+    const MSVCRT_wchar_t *s = str;
+    const ULONG_PTR *word;
+
+    if ((ULONG_PTR)s & 1)
+        return strlenW(s);
+
+    for (; (ULONG_PTR)s & (sizeof(ULONG_PTR) - 1); s++)
+        if (!*s) return s - str;
+
+    for (word = (const ULONG_PTR *)s; !WCS_WORD_HAS_ZERO(*word); word++);
+
+    for (s = (const MSVCRT_wchar_t *)word; *s; s++);
+    return s - str;
 }
 
 /*********************************************************************
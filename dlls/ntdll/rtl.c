@@ -1212,6 +1212,457 @@ PSLIST_ENTRY WINAPI RtlInterlockedPushListSList(PSLIST_HEADER list, PSLIST_ENTRY
 #endif
 }
 
+/* Compression support for RtlCompressBuffer and RtlDecompressBuffer.
+ *
+ * Both encoders share a hash chain match finder keyed on three byte prefixes.
+ * The chain depth is chosen by the compression engine: the maximum engine
+ * searches much deeper chains for a better ratio. */
+
+#define LZ_HASH_BITS        12
+#define LZ_WINDOW_SIZE      8192
+#define LZ_MIN_MATCH        3
+#define LZ_NO_POS           (~0u)
+
+#define LZNT1_CHUNK_SIZE    4096
+#define XPRESS_MAX_OFFSET   8192
+
+struct lz_workspace
+{
+    ULONG head[1 << LZ_HASH_BITS];
+    ULONG prev[LZ_WINDOW_SIZE];
+};
+
+static inline ULONG lz_hash( const UCHAR *p )
+{
+    return (((p[0] << 16) | (p[1] << 8) | p[2]) * 0x9e3779b1) >> (32 - LZ_HASH_BITS);
+}
+
+static inline void lz_insert( struct lz_workspace *ws, const UCHAR *buf, ULONG pos, ULONG size )
+{
+    ULONG hash;
+
+    if (pos + LZ_MIN_MATCH > size) return;
+    hash = lz_hash( buf + pos );
+    ws->prev[pos & (LZ_WINDOW_SIZE - 1)] = ws->head[hash];
+    ws->head[hash] = pos;
+}
+
+/* find the longest match for buf[pos] among earlier positions >= min_pos */
+static ULONG lz_find_match( struct lz_workspace *ws, const UCHAR *buf, ULONG pos, ULONG min_pos,
+                            ULONG end, ULONG max_offset, ULONG max_len, ULONG depth, ULONG *offset )
+{
+    ULONG cand, len, best = 0;
+
+    if (end - pos < LZ_MIN_MATCH) return 0;
+    if (max_len > end - pos) max_len = end - pos;
+
+    cand = ws->head[lz_hash( buf + pos )];
+    while (depth-- && cand != LZ_NO_POS && cand < pos && cand >= min_pos && pos - cand <= max_offset)
+    {
+        if (buf[cand + best] == buf[pos + best] && buf[cand] == buf[pos])
+        {
+            for (len = 0; len < max_len && buf[cand + len] == buf[pos + len]; len++);
+            if (len > best)
+            {
+                best = len;
+                *offset = pos - cand;
+                if (best == max_len) break;
+            }
+        }
+        cand = ws->prev[cand & (LZ_WINDOW_SIZE - 1)];
+    }
+
+    return best >= LZ_MIN_MATCH ? best : 0;
+}
+
+static ULONG lz_chain_depth( USHORT engine )
+{
+    return engine == COMPRESSION_ENGINE_MAXIMUM ? 256 : 8;
+}
+
+/* number of low bits used for the match length at a given position in a LZNT1 chunk */
+static inline ULONG lznt1_length_bits( ULONG chunk_pos )
+{
+    ULONG bits = 12;
+
+    for (chunk_pos--; chunk_pos >= 0x10; chunk_pos >>= 1) bits--;
+    return bits;
+}
+
+/* compress one chunk, returns the compressed size or 0 if it doesn't fit */
+static ULONG lznt1_compress_chunk( struct lz_workspace *ws, const UCHAR *buf, ULONG start, ULONG end,
+                                   ULONG size, UCHAR *dst, ULONG dst_size, ULONG depth )
+{
+    UCHAR *dst_cur = dst, *dst_end = dst + dst_size, *flags_ptr;
+    ULONG pos = start, len, offset, bits, i;
+    UCHAR flags;
+
+    while (pos < end)
+    {
+        if (dst_cur >= dst_end) return 0;
+        flags_ptr = dst_cur++;
+        flags = 0;
+
+        for (i = 0; i < 8 && pos < end; i++)
+        {
+            len = 0;
+            if (pos > start)
+            {
+                bits = lznt1_length_bits( pos - start );
+                len = lz_find_match( ws, buf, pos, start, end, 1 << (16 - bits),
+                                     (1 << bits) - 1 + LZ_MIN_MATCH, depth, &offset );
+            }
+
+            if (len)
+            {
+                USHORT token = ((offset - 1) << bits) | (len - LZ_MIN_MATCH);
+
+                if (dst_end - dst_cur < 2) return 0;
+                *dst_cur++ = token & 0xff;
+                *dst_cur++ = token >> 8;
+                flags |= 1 << i;
+                while (len--) lz_insert( ws, buf, pos++, size );
+            }
+            else
+            {
+                if (dst_cur >= dst_end) return 0;
+                *dst_cur++ = buf[pos];
+                lz_insert( ws, buf, pos++, size );
+            }
+        }
+        *flags_ptr = flags;
+    }
+
+    return dst_cur - dst;
+}
+
+static NTSTATUS lznt1_compress( USHORT engine, const UCHAR *src, ULONG src_size, UCHAR *dst,
+                                ULONG dst_size, ULONG *final_size, void *workspace )
+{
+    struct lz_workspace *ws = workspace;
+    ULONG depth = lz_chain_depth( engine );
+    UCHAR *dst_cur = dst, *dst_end = dst + dst_size;
+    ULONG pos, end, len;
+
+    memset( ws->head, 0xff, sizeof(ws->head) );
+
+    for (pos = 0; pos < src_size; pos = end)
+    {
+        end = min( pos + LZNT1_CHUNK_SIZE, src_size );
+        if (dst_end - dst_cur < 2) return STATUS_BUFFER_TOO_SMALL;
+
+        /* store the chunk uncompressed if compressing doesn't make it smaller */
+        len = lznt1_compress_chunk( ws, src, pos, end, src_size, dst_cur + 2,
+                                    min( dst_end - dst_cur - 2, end - pos - 1 ), depth );
+        if (len)
+        {
+            dst_cur[0] = (len - 1) & 0xff;
+            dst_cur[1] = 0xb0 | ((len - 1) >> 8);
+        }
+        else
+        {
+            len = end - pos;
+            if (dst_end - dst_cur - 2 < len) return STATUS_BUFFER_TOO_SMALL;
+            memcpy( dst_cur + 2, src + pos, len );
+            dst_cur[0] = (len - 1) & 0xff;
+            dst_cur[1] = 0x30 | ((len - 1) >> 8);
+        }
+        dst_cur += len + 2;
+    }
+
+    /* terminate the stream if there is room left, it is not included in the size */
+    if (dst_end - dst_cur >= 2) dst_cur[0] = dst_cur[1] = 0;
+
+    *final_size = dst_cur - dst;
+    return STATUS_SUCCESS;
+}
+
+/* decompress one chunk, returns the end of the output or NULL for corrupted data */
+static UCHAR *lznt1_decompress_chunk( UCHAR *dst, ULONG dst_size, const UCHAR *src, ULONG src_size )
+{
+    const UCHAR *src_cur = src, *src_end = src + src_size;
+    UCHAR *dst_cur = dst, *dst_end = dst + dst_size;
+    ULONG len, offset, bits, i, j;
+    USHORT token;
+    UCHAR flags;
+
+    while (src_cur < src_end && dst_cur < dst_end)
+    {
+        flags = *src_cur++;
+        for (i = 0; i < 8 && src_cur < src_end && dst_cur < dst_end; i++, flags >>= 1)
+        {
+            if (!(flags & 1))
+            {
+                *dst_cur++ = *src_cur++;
+                continue;
+            }
+
+            if (src_end - src_cur < 2 || dst_cur == dst) return NULL;
+            token = src_cur[0] | (src_cur[1] << 8);
+            src_cur += 2;
+
+            bits = lznt1_length_bits( dst_cur - dst );
+            len = (token & ((1 << bits) - 1)) + LZ_MIN_MATCH;
+            offset = (token >> bits) + 1;
+            if (offset > dst_cur - dst) return NULL;
+
+            /* truncate the match if the output buffer is too small */
+            len = min( len, dst_end - dst_cur );
+            if (offset >= len)
+                memcpy( dst_cur, dst_cur - offset, len );
+            else
+            {
+                const UCHAR *match = dst_cur - offset;
+                for (j = 0; j < len; j++) dst_cur[j] = match[j];
+            }
+            dst_cur += len;
+        }
+    }
+
+    return dst_cur;
+}
+
+static NTSTATUS lznt1_decompress( UCHAR *dst, ULONG dst_size, const UCHAR *src, ULONG src_size,
+                                  ULONG *final_size )
+{
+    const UCHAR *src_cur = src, *src_end = src + src_size;
+    UCHAR *dst_cur = dst, *dst_end = dst + dst_size, *chunk_end;
+    ULONG chunk_size, chunk_out;
+    USHORT header;
+
+    while (src_end - src_cur >= 2 && dst_cur < dst_end)
+    {
+        header = src_cur[0] | (src_cur[1] << 8);
+        if (!header) break;
+        src_cur += 2;
+
+        chunk_size = (header & 0xfff) + 1;
+        if (chunk_size > src_end - src_cur) return STATUS_BAD_COMPRESSION_BUFFER;
+        chunk_out = min( LZNT1_CHUNK_SIZE, dst_end - dst_cur );
+
+        if (header & 0x8000)
+        {
+            if (!(chunk_end = lznt1_decompress_chunk( dst_cur, chunk_out, src_cur, chunk_size )))
+                return STATUS_BAD_COMPRESSION_BUFFER;
+        }
+        else
+        {
+            chunk_end = dst_cur + min( chunk_size, chunk_out );
+            memcpy( dst_cur, src_cur, chunk_end - dst_cur );
+        }
+        src_cur += chunk_size;
+
+        /* every chunk but the last one decompresses to a full chunk, pad short ones */
+        if (src_end - src_cur >= 2 && (src_cur[0] || src_cur[1]))
+        {
+            memset( chunk_end, 0, dst_cur + chunk_out - chunk_end );
+            chunk_end = dst_cur + chunk_out;
+        }
+        dst_cur = chunk_end;
+    }
+
+    *final_size = dst_cur - dst;
+    return STATUS_SUCCESS;
+}
+
+static NTSTATUS xpress_compress( USHORT engine, const UCHAR *src, ULONG src_size, UCHAR *dst,
+                                 ULONG dst_size, ULONG *final_size, void *workspace )
+{
+    struct lz_workspace *ws = workspace;
+    ULONG depth = lz_chain_depth( engine );
+    ULONG pos = 0, len, offset, token, flags = 0, flag_cnt = 0;
+    UCHAR *dst_cur = dst, *dst_end = dst + dst_size, *flags_ptr, *half_byte = NULL;
+
+    memset( ws->head, 0xff, sizeof(ws->head) );
+
+    if (dst_size < 4) return STATUS_BUFFER_TOO_SMALL;
+    flags_ptr = dst_cur;
+    dst_cur += 4;
+
+    while (pos < src_size)
+    {
+        len = lz_find_match( ws, src, pos, 0, src_size, XPRESS_MAX_OFFSET, ~0u, depth, &offset );
+        if (len)
+        {
+            /* the worst case is a 2 byte token, a length nibble and 7 extra length bytes */
+            if (dst_end - dst_cur < 10) return STATUS_BUFFER_TOO_SMALL;
+
+            token = (offset - 1) << 3;
+            if (len - LZ_MIN_MATCH < 7)
+            {
+                token |= len - LZ_MIN_MATCH;
+                *dst_cur++ = token & 0xff;
+                *dst_cur++ = token >> 8;
+            }
+            else
+            {
+                ULONG extra = len - LZ_MIN_MATCH - 7;
+
+                token |= 7;
+                *dst_cur++ = token & 0xff;
+                *dst_cur++ = token >> 8;
+
+                if (!half_byte)
+                {
+                    half_byte = dst_cur;
+                    *dst_cur++ = min( extra, 15 );
+                }
+                else
+                {
+                    *half_byte |= min( extra, 15 ) << 4;
+                    half_byte = NULL;
+                }
+
+                if (extra >= 15)
+                {
+                    extra -= 15;
+                    if (extra < 255)
+                        *dst_cur++ = extra;
+                    else
+                    {
+                        *dst_cur++ = 255;
+                        extra += 15 + 7;
+                        if (extra < 0x10000)
+                        {
+                            *dst_cur++ = extra & 0xff;
+                            *dst_cur++ = extra >> 8;
+                        }
+                        else
+                        {
+                            *dst_cur++ = 0;
+                            *dst_cur++ = 0;
+                            *dst_cur++ = extra & 0xff;
+                            *dst_cur++ = (extra >> 8) & 0xff;
+                            *dst_cur++ = (extra >> 16) & 0xff;
+                            *dst_cur++ = extra >> 24;
+                        }
+                    }
+                }
+            }
+            flags = (flags << 1) | 1;
+            while (len--) lz_insert( ws, src, pos++, src_size );
+        }
+        else
+        {
+            if (dst_cur >= dst_end) return STATUS_BUFFER_TOO_SMALL;
+            *dst_cur++ = src[pos];
+            flags <<= 1;
+            lz_insert( ws, src, pos++, src_size );
+        }
+
+        if (++flag_cnt == 32)
+        {
+            flags_ptr[0] = flags & 0xff;
+            flags_ptr[1] = (flags >> 8) & 0xff;
+            flags_ptr[2] = (flags >> 16) & 0xff;
+            flags_ptr[3] = flags >> 24;
+            if (dst_end - dst_cur < 4) return STATUS_BUFFER_TOO_SMALL;
+            flags_ptr = dst_cur;
+            dst_cur += 4;
+            flags = flag_cnt = 0;
+        }
+    }
+
+    /* the unused flag bits are set, so the decoder stops at the end of the input */
+    if (flag_cnt) flags = (flags << (32 - flag_cnt)) | ((1u << (32 - flag_cnt)) - 1);
+    else flags = ~0u;
+    flags_ptr[0] = flags & 0xff;
+    flags_ptr[1] = (flags >> 8) & 0xff;
+    flags_ptr[2] = (flags >> 16) & 0xff;
+    flags_ptr[3] = flags >> 24;
+
+    *final_size = dst_cur - dst;
+    return STATUS_SUCCESS;
+}
+
+static NTSTATUS xpress_decompress( UCHAR *dst, ULONG dst_size, const UCHAR *src, ULONG src_size,
+                                   ULONG *final_size )
+{
+    const UCHAR *src_cur = src, *src_end = src + src_size, *half_byte = NULL;
+    UCHAR *dst_cur = dst, *dst_end = dst + dst_size;
+    ULONG flags = 0, flag_cnt = 0, len, offset, i;
+
+    while (dst_cur < dst_end)
+    {
+        if (!flag_cnt)
+        {
+            if (src_end - src_cur < 4) break;
+            flags = src_cur[0] | (src_cur[1] << 8) | (src_cur[2] << 16) | ((ULONG)src_cur[3] << 24);
+            src_cur += 4;
+            flag_cnt = 32;
+        }
+        flag_cnt--;
+
+        if (src_cur == src_end) break;
+
+        if (!(flags & (1u << flag_cnt)))
+        {
+            *dst_cur++ = *src_cur++;
+            continue;
+        }
+
+        if (src_end - src_cur < 2) return STATUS_BAD_COMPRESSION_BUFFER;
+        len = src_cur[0] | (src_cur[1] << 8);
+        src_cur += 2;
+        offset = (len >> 3) + 1;
+        len &= 7;
+
+        if (len == 7)
+        {
+            if (!half_byte)
+            {
+                if (src_cur == src_end) return STATUS_BAD_COMPRESSION_BUFFER;
+                half_byte = src_cur++;
+                len = *half_byte & 0xf;
+            }
+            else
+            {
+                len = *half_byte >> 4;
+                half_byte = NULL;
+            }
+
+            if (len == 15)
+            {
+                if (src_cur == src_end) return STATUS_BAD_COMPRESSION_BUFFER;
+                len = *src_cur++;
+                if (len == 255)
+                {
+                    if (src_end - src_cur < 2) return STATUS_BAD_COMPRESSION_BUFFER;
+                    len = src_cur[0] | (src_cur[1] << 8);
+                    src_cur += 2;
+                    if (!len)
+                    {
+                        if (src_end - src_cur < 4) return STATUS_BAD_COMPRESSION_BUFFER;
+                        len = src_cur[0] | (src_cur[1] << 8) | (src_cur[2] << 16) | ((ULONG)src_cur[3] << 24);
+                        src_cur += 4;
+                    }
+                    if (len < 15 + 7) return STATUS_BAD_COMPRESSION_BUFFER;
+                    len -= 15 + 7;
+                }
+                len += 15;
+            }
+            len += 7;
+        }
+        len += LZ_MIN_MATCH;
+
+        if (offset > dst_cur - dst) return STATUS_BAD_COMPRESSION_BUFFER;
+
+        /* truncate the match if the output buffer is too small */
+        len = min( len, dst_end - dst_cur );
+        if (offset >= len)
+            memcpy( dst_cur, dst_cur - offset, len );
+        else
+        {
+            const UCHAR *match = dst_cur - offset;
+            for (i = 0; i < len; i++) dst_cur[i] = match[i];
+        }
+        dst_cur += len;
+    }
+
+    *final_size = dst_cur - dst;
+    return STATUS_SUCCESS;
+}
+
 /******************************************************************************
  *  RtlGetCompressionWorkSpaceSize		[NTDLL.@]
  */
@@ -1219,10 +1670,30 @@ NTSTATUS WINAPI RtlGetCompressionWorkSpaceSize(USHORT CompressionFormatAndEngine
                                                PULONG CompressBufferWorkSpaceSize,
                                                PULONG CompressFragmentWorkSpaceSize)
 {
-    FIXME("0x%04x, %p, %p: stub!\n", CompressionFormatAndEngine, CompressBufferWorkSpaceSize,
-         CompressFragmentWorkSpaceSize);
+    USHORT format = CompressionFormatAndEngine & 0x00ff;
+    USHORT engine = CompressionFormatAndEngine & 0xff00;
 
-    return STATUS_NOT_IMPLEMENTED;
+    TRACE("0x%04x, %p, %p\n", CompressionFormatAndEngine, CompressBufferWorkSpaceSize,
+          CompressFragmentWorkSpaceSize);
+
+    switch (format)
+    {
+    case COMPRESSION_FORMAT_NONE:
+    case COMPRESSION_FORMAT_DEFAULT:
+        return STATUS_INVALID_PARAMETER;
+    case COMPRESSION_FORMAT_LZNT1:
+    case COMPRESSION_FORMAT_XPRESS:
+        if (engine != COMPRESSION_ENGINE_STANDARD && engine != COMPRESSION_ENGINE_MAXIMUM)
+            return STATUS_NOT_SUPPORTED;
+        *CompressBufferWorkSpaceSize = sizeof(struct lz_workspace);
+        *CompressFragmentWorkSpaceSize = 0;
+        return STATUS_SUCCESS;
+    case COMPRESSION_FORMAT_XPRESS_HUFF:
+        FIXME("format 0x%04x not supported\n", format);
+        return STATUS_UNSUPPORTED_COMPRESSION;
+    default:
+        return STATUS_UNSUPPORTED_COMPRESSION;
+    }
 }
 
 /******************************************************************************
@@ -1233,11 +1704,36 @@ NTSTATUS WINAPI RtlCompressBuffer(USHORT CompressionFormatAndEngine, PUCHAR Unco
                                   ULONG CompressedBufferSize, ULONG UncompressedChunkSize,
                                   PULONG FinalCompressedSize, PVOID WorkSpace)
 {
-    FIXME("0x%04x, %p, %u, %p, %u, %u, %p, %p :stub\n", CompressionFormatAndEngine, UncompressedBuffer,
-         UncompressedBufferSize, CompressedBuffer, CompressedBufferSize, UncompressedChunkSize,
-         FinalCompressedSize, WorkSpace);
+    USHORT format = CompressionFormatAndEngine & 0x00ff;
+    USHORT engine = CompressionFormatAndEngine & 0xff00;
 
-    return STATUS_NOT_IMPLEMENTED;
+    TRACE("0x%04x, %p, %u, %p, %u, %u, %p, %p\n", CompressionFormatAndEngine, UncompressedBuffer,
+          UncompressedBufferSize, CompressedBuffer, CompressedBufferSize, UncompressedChunkSize,
+          FinalCompressedSize, WorkSpace);
+
+    switch (format)
+    {
+    case COMPRESSION_FORMAT_NONE:
+    case COMPRESSION_FORMAT_DEFAULT:
+        return STATUS_INVALID_PARAMETER;
+    case COMPRESSION_FORMAT_LZNT1:
+    case COMPRESSION_FORMAT_XPRESS:
+        break;
+    case COMPRESSION_FORMAT_XPRESS_HUFF:
+        FIXME("format 0x%04x not supported\n", format);
+        return STATUS_UNSUPPORTED_COMPRESSION;
+    default:
+        return STATUS_UNSUPPORTED_COMPRESSION;
+    }
+
+    if (engine != COMPRESSION_ENGINE_STANDARD && engine != COMPRESSION_ENGINE_MAXIMUM)
+        return STATUS_NOT_SUPPORTED;
+
+    if (format == COMPRESSION_FORMAT_LZNT1)
+        return lznt1_compress( engine, UncompressedBuffer, UncompressedBufferSize, CompressedBuffer,
+                               CompressedBufferSize, FinalCompressedSize, WorkSpace );
+    return xpress_compress( engine, UncompressedBuffer, UncompressedBufferSize, CompressedBuffer,
+                            CompressedBufferSize, FinalCompressedSize, WorkSpace );
 }
 
 /******************************************************************************
@@ -1247,10 +1743,26 @@ NTSTATUS WINAPI RtlDecompressBuffer(USHORT CompressionFormat, PUCHAR Uncompresse
                                     ULONG UncompressedBufferSize, PUCHAR CompressedBuffer,
                                     ULONG CompressedBufferSize, PULONG FinalUncompressedSize)
 {
-    FIXME("0x%04x, %p, %u, %p, %u, %p :stub\n", CompressionFormat, UncompressedBuffer, UncompressedBufferSize,
-         CompressedBuffer, CompressedBufferSize, FinalUncompressedSize);
+    TRACE("0x%04x, %p, %u, %p, %u, %p\n", CompressionFormat, UncompressedBuffer, UncompressedBufferSize,
+          CompressedBuffer, CompressedBufferSize, FinalUncompressedSize);
 
-    return STATUS_NOT_IMPLEMENTED;
+    switch (CompressionFormat & 0x00ff)
+    {
+    case COMPRESSION_FORMAT_NONE:
+    case COMPRESSION_FORMAT_DEFAULT:
+        return STATUS_INVALID_PARAMETER;
+    case COMPRESSION_FORMAT_LZNT1:
+        return lznt1_decompress( UncompressedBuffer, UncompressedBufferSize, CompressedBuffer,
+                                 CompressedBufferSize, FinalUncompressedSize );
+    case COMPRESSION_FORMAT_XPRESS:
+        return xpress_decompress( UncompressedBuffer, UncompressedBufferSize, CompressedBuffer,
+                                  CompressedBufferSize, FinalUncompressedSize );
+    case COMPRESSION_FORMAT_XPRESS_HUFF:
+        FIXME("format 0x%04x not supported\n", CompressionFormat);
+        return STATUS_UNSUPPORTED_COMPRESSION;
+    default:
+        return STATUS_UNSUPPORTED_COMPRESSION;
+    }
 }
 
 /***********************************************************************
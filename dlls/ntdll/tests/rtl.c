@@ -92,6 +92,9 @@ static NTSTATUS  (WINAPI *pRtlIpv4StringToAddressA)(PCSTR, BOOLEAN, PCSTR *, IN_
 static NTSTATUS  (WINAPI *pLdrAddRefDll)(ULONG, HMODULE);
 static NTSTATUS  (WINAPI *pLdrLockLoaderLock)(ULONG, ULONG*, ULONG*);
 static NTSTATUS  (WINAPI *pLdrUnlockLoaderLock)(ULONG, ULONG);
+static NTSTATUS  (WINAPI *pRtlGetCompressionWorkSpaceSize)(USHORT, PULONG, PULONG);
+static NTSTATUS  (WINAPI *pRtlCompressBuffer)(USHORT, PUCHAR, ULONG, PUCHAR, ULONG, ULONG, PULONG, PVOID);
+static NTSTATUS  (WINAPI *pRtlDecompressBuffer)(USHORT, PUCHAR, ULONG, PUCHAR, ULONG, PULONG);
 
 static HMODULE hkernel32 = 0;
 static BOOL      (WINAPI *pIsWow64Process)(HANDLE, PBOOL);
@@ -139,6 +142,9 @@ static void InitFunctionPtrs(void)
         pLdrAddRefDll = (void *)GetProcAddress(hntdll, "LdrAddRefDll");
         pLdrLockLoaderLock = (void *)GetProcAddress(hntdll, "LdrLockLoaderLock");
         pLdrUnlockLoaderLock = (void *)GetProcAddress(hntdll, "LdrUnlockLoaderLock");
+        pRtlGetCompressionWorkSpaceSize = (void *)GetProcAddress(hntdll, "RtlGetCompressionWorkSpaceSize");
+        pRtlCompressBuffer = (void *)GetProcAddress(hntdll, "RtlCompressBuffer");
+        pRtlDecompressBuffer = (void *)GetProcAddress(hntdll, "RtlDecompressBuffer");
     }
     hkernel32 = LoadLibraryA("kernel32.dll");
     ok(hkernel32 != 0, "LoadLibrary failed\n");
@@ -1598,6 +1604,116 @@ static void test_LdrLockLoaderLock(void)
     pLdrUnlockLoaderLock(0, magic);
 }
 
+static void test_RtlDecompressBuffer(void)
+{
+    static const UCHAR compressed[] = {0x07, 0xb0, 0x20, 'W', 'i', 'n', 'e', ' ', 0x01, 0x40};
+    static const UCHAR raw_chunks[] = {0x03, 0x30, 'W', 'i', 'n', 'e', 0x03, 0x30, 'W', 'i', 'n', 'e'};
+    static const UCHAR corrupted[] = {0x03, 0xb0, 0x01, 0x00, 0x00};
+    static UCHAR buf[0x2000];
+    NTSTATUS status;
+    ULONG size, i;
+
+    if (!pRtlDecompressBuffer)
+    {
+        win_skip("RtlDecompressBuffer is not available\n");
+        return;
+    }
+
+    size = 0xdeadbeef;
+    status = pRtlDecompressBuffer(COMPRESSION_FORMAT_LZNT1, buf, sizeof(buf), (UCHAR *)compressed,
+                                  sizeof(compressed), &size);
+    ok(status == STATUS_SUCCESS, "got %08x\n", status);
+    ok(size == 9, "got %u\n", size);
+    ok(!memcmp(buf, "Wine Wine", 9), "wrong data\n");
+
+    /* all chunks but the last one are padded to the full chunk size */
+    memset(buf, 0xcc, sizeof(buf));
+    size = 0xdeadbeef;
+    status = pRtlDecompressBuffer(COMPRESSION_FORMAT_LZNT1, buf, sizeof(buf), (UCHAR *)raw_chunks,
+                                  sizeof(raw_chunks), &size);
+    ok(status == STATUS_SUCCESS, "got %08x\n", status);
+    ok(size == 0x1004, "got %u\n", size);
+    ok(!memcmp(buf, "Wine", 4), "wrong data\n");
+    for (i = 4; i < 0x1000; i++) if (buf[i]) break;
+    ok(i == 0x1000, "got nonzero byte at %u\n", i);
+    ok(!memcmp(buf + 0x1000, "Wine", 4), "wrong data\n");
+
+    status = pRtlDecompressBuffer(COMPRESSION_FORMAT_LZNT1, buf, sizeof(buf), (UCHAR *)corrupted,
+                                  sizeof(corrupted), &size);
+    ok(status == STATUS_BAD_COMPRESSION_BUFFER, "got %08x\n", status);
+
+    status = pRtlDecompressBuffer(COMPRESSION_FORMAT_NONE, buf, sizeof(buf), (UCHAR *)compressed,
+                                  sizeof(compressed), &size);
+    ok(status == STATUS_INVALID_PARAMETER, "got %08x\n", status);
+}
+
+static void test_RtlCompressBuffer(void)
+{
+    static const USHORT formats[] =
+    {
+        COMPRESSION_FORMAT_LZNT1 | COMPRESSION_ENGINE_STANDARD,
+        COMPRESSION_FORMAT_LZNT1 | COMPRESSION_ENGINE_MAXIMUM,
+        COMPRESSION_FORMAT_XPRESS | COMPRESSION_ENGINE_STANDARD,
+        COMPRESSION_FORMAT_XPRESS | COMPRESSION_ENGINE_MAXIMUM,
+    };
+    static const char text[] = "Wine is not an emulator. ";
+    ULONG data_size = 0x3000, ws_size, frag_size, size, out_size, seed = 1, i, j;
+    UCHAR *data, *compressed, *out;
+    NTSTATUS status;
+    void *ws;
+
+    if (!pRtlCompressBuffer || !pRtlGetCompressionWorkSpaceSize)
+    {
+        win_skip("RtlCompressBuffer is not available\n");
+        return;
+    }
+
+    data = HeapAlloc(GetProcessHeap(), 0, data_size);
+    compressed = HeapAlloc(GetProcessHeap(), 0, data_size * 2);
+    out = HeapAlloc(GetProcessHeap(), 0, data_size);
+
+    /* repeated text followed by data that doesn't compress */
+    for (i = 0; i < 0x2000; i++) data[i] = text[i % (sizeof(text) - 1)];
+    for (; i < data_size; i++) data[i] = pRtlRandom(&seed);
+
+    for (i = 0; i < sizeof(formats) / sizeof(formats[0]); i++)
+    {
+        status = pRtlGetCompressionWorkSpaceSize(formats[i], &ws_size, &frag_size);
+        if (status == STATUS_UNSUPPORTED_COMPRESSION || status == STATUS_NOT_SUPPORTED)
+        {
+            win_skip("format %04x not supported\n", formats[i]);
+            continue;
+        }
+        ok(status == STATUS_SUCCESS, "%04x: got %08x\n", formats[i], status);
+        ws = HeapAlloc(GetProcessHeap(), 0, ws_size);
+
+        size = 0xdeadbeef;
+        status = pRtlCompressBuffer(formats[i], data, data_size, compressed, data_size * 2, 0x1000, &size, ws);
+        ok(status == STATUS_SUCCESS, "%04x: got %08x\n", formats[i], status);
+        ok(size < data_size - 0x1000, "%04x: got size %u\n", formats[i], size);
+
+        out_size = 0xdeadbeef;
+        memset(out, 0, data_size);
+        status = pRtlDecompressBuffer(formats[i] & 0xff, out, data_size, compressed, size, &out_size);
+        ok(status == STATUS_SUCCESS, "%04x: got %08x\n", formats[i], status);
+        ok(out_size == data_size, "%04x: got %u\n", formats[i], out_size);
+        for (j = 0; j < data_size; j++) if (out[j] != data[j]) break;
+        ok(j == data_size, "%04x: data differs at %u\n", formats[i], j);
+
+        status = pRtlCompressBuffer(formats[i], data, data_size, compressed, 16, 0x1000, &size, ws);
+        ok(status == STATUS_BUFFER_TOO_SMALL, "%04x: got %08x\n", formats[i], status);
+
+        HeapFree(GetProcessHeap(), 0, ws);
+    }
+
+    status = pRtlGetCompressionWorkSpaceSize(COMPRESSION_FORMAT_NONE, &ws_size, &frag_size);
+    ok(status == STATUS_INVALID_PARAMETER, "got %08x\n", status);
+
+    HeapFree(GetProcessHeap(), 0, data);
+    HeapFree(GetProcessHeap(), 0, compressed);
+    HeapFree(GetProcessHeap(), 0, out);
+}
+
 START_TEST(rtl)
 {
     InitFunctionPtrs();
@@ -1624,4 +1740,6 @@ START_TEST(rtl)
     test_RtlIpv4StringToAddress();
     test_LdrAddRefDll();
     test_LdrLockLoaderLock();
+    test_RtlDecompressBuffer();
+    test_RtlCompressBuffer();
 }
@@ -6868,6 +6868,22 @@ ULONG BlockChainStream_GetSectorOfOffset(BlockChainStream *This, ULONG offset)
   return This->indexCache[min_run].firstSector + offset - This->indexCache[min_run].firstOffset;
 }
 
+/* Count the blocks starting at index that are stored in consecutive sectors
+ * and are not held in the block cache, up to max blocks. */
+static ULONG BlockChainStream_GetContiguousBlocks(BlockChainStream *This,
+    ULONG index, ULONG sector, ULONG max)
+{
+  ULONG count = 1;
+
+  while (count < max &&
+         This->cachedBlocks[0].index != index + count &&
+         This->cachedBlocks[1].index != index + count &&
+         BlockChainStream_GetSectorOfOffset(This, index + count) == sector + count)
+    count++;
+
+  return count;
+}
+
 HRESULT BlockChainStream_GetBlockAtOffset(BlockChainStream *This,
     ULONG index, BlockChainBlock **block, ULONG *sector, BOOL create)
 {
@@ -7062,6 +7078,7 @@ HRESULT BlockChainStream_ReadAt(BlockChainStream* This,
   {
     ULARGE_INTEGER ulOffset;
     DWORD bytesReadAt;
+    ULONG blocks = 1;
 
     /*
      * Calculate how many bytes we can copy from this big block.
@@ -7076,7 +7093,13 @@ HRESULT BlockChainStream_ReadAt(BlockChainStream* This,
 
     if (!cachedBlock)
     {
-      /* Not in cache, and we're going to read past the end of the block. */
+      /* Not in cache, and we're going to read past the end of the block.
+       * Read every following block up to the last one in a single call if
+       * they are stored contiguously. */
+      blocks = BlockChainStream_GetContiguousBlocks(This, blockNoInSequence, blockIndex,
+          (offsetInBlock + size - 1) / This->parentStorage->bigBlockSize);
+      bytesToReadInBuffer = blocks * This->parentStorage->bigBlockSize - offsetInBlock;
+
       ulOffset.u.HighPart = 0;
       ulOffset.u.LowPart = StorageImpl_GetBigBlockOffset(This->parentStorage, blockIndex) +
                                offsetInBlock;
@@ -7102,7 +7125,7 @@ HRESULT BlockChainStream_ReadAt(BlockChainStream* This,
       bytesReadAt = bytesToReadInBuffer;
     }
 
-    blockNoInSequence++;
+    blockNoInSequence += blocks;
     bufferWalker += bytesReadAt;
     size         -= bytesReadAt;
     *bytesRead   += bytesReadAt;
@@ -7142,6 +7165,7 @@ HRESULT BlockChainStream_WriteAt(BlockChainStream* This,
   {
     ULARGE_INTEGER ulOffset;
     DWORD bytesWrittenAt;
+    ULONG blocks = 1;
 
     /*
      * Calculate how many bytes we can copy to this big block.
@@ -7161,7 +7185,12 @@ HRESULT BlockChainStream_WriteAt(BlockChainStream* This,
 
     if (!cachedBlock)
     {
-      /* Not in cache, and we're going to write past the end of the block. */
+      /* Not in cache, and we're going to write past the end of the block.
+       * Coalesce the write with the following contiguous blocks. */
+      blocks = BlockChainStream_GetContiguousBlocks(This, blockNoInSequence, blockIndex,
+          (offsetInBlock + size - 1) / This->parentStorage->bigBlockSize);
+      bytesToWrite = blocks * This->parentStorage->bigBlockSize - offsetInBlock;
+
       ulOffset.u.HighPart = 0;
       ulOffset.u.LowPart = StorageImpl_GetBigBlockOffset(This->parentStorage, blockIndex) +
                                offsetInBlock;
@@ -7187,7 +7216,7 @@ HRESULT BlockChainStream_WriteAt(BlockChainStream* This,
       cachedBlock->dirty = TRUE;
     }
 
-    blockNoInSequence++;
+    blockNoInSequence += blocks;
     bufferWalker  += bytesWrittenAt;
     size          -= bytesWrittenAt;
     *bytesWritten += bytesWrittenAt;
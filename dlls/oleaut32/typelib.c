@@ -1188,6 +1188,7 @@ typedef struct tagTLBFuncDesc
     const TLBString *HelpString;
     const TLBString *Entry;            /* if IS_INTRESOURCE true, it's numeric; if -1 it isn't present */
     struct list custdata_list;
+    VARTYPE *invoke_vts;    /* variant types of the params and the return value, cached by Invoke */
 } TLBFuncDesc;
 
 /* internal Variable data */
@@ -1299,6 +1300,12 @@ typedef struct tagTLBContext
 	void *mapping;        /* memory mapping */
 	MSFT_SegDir * pTblDir;
 	ITypeLibImpl* pLibInfo;
+	TLBString **names;    /* name table entries, ordered by offset */
+	UINT names_count;
+	TLBString **strings;  /* string table entries, ordered by offset */
+	UINT strings_count;
+	TLBGuid **guids;      /* guid table entries, ordered by offset */
+	UINT guids_count;
 } TLBContext;
 
 
@@ -2111,6 +2118,10 @@ static HRESULT MSFT_ReadAllGuids(TLBContext *pcx)
     MSFT_GuidEntry entry;
     int offs = 0;
 
+    pcx->guids = heap_alloc(sizeof(TLBGuid *) * (max(pcx->pTblDir->pGuidTab.length, 0) / sizeof(MSFT_GuidEntry) + 1));
+    if (!pcx->guids)
+        return E_OUTOFMEMORY;
+
     MSFT_Seek(pcx, pcx->pTblDir->pGuidTab.offset);
     while (1) {
         if (offs >= pcx->pTblDir->pGuidTab.length)
@@ -2125,6 +2136,7 @@ static HRESULT MSFT_ReadAllGuids(TLBContext *pcx)
         guid->hreftype = entry.hreftype;
 
         list_add_tail(&pcx->pLibInfo->guid_list, &guid->entry);
+        pcx->guids[pcx->guids_count++] = guid;
 
         offs += sizeof(MSFT_GuidEntry);
     }
@@ -2133,15 +2145,18 @@ static HRESULT MSFT_ReadAllGuids(TLBContext *pcx)
 static TLBGuid *MSFT_ReadGuid( int offset, TLBContext *pcx)
 {
     TLBGuid *ret;
+    UINT index;
 
-    LIST_FOR_EACH_ENTRY(ret, &pcx->pLibInfo->guid_list, TLBGuid, entry){
-        if(ret->offset == offset){
-            TRACE_(typelib)("%s\n", debugstr_guid(&ret->guid));
-            return ret;
-        }
-    }
+    if (offset < 0 || offset % sizeof(MSFT_GuidEntry))
+        return NULL;
 
-    return NULL;
+    index = offset / sizeof(MSFT_GuidEntry);
+    if (index >= pcx->guids_count)
+        return NULL;
+
+    ret = pcx->guids[index];
+    TRACE_(typelib)("%s\n", debugstr_guid(&ret->guid));
+    return ret;
 }
 
 static HREFTYPE MSFT_ReadHreftype( TLBContext *pcx, int offset )
@@ -2160,6 +2175,25 @@ static HREFTYPE MSFT_ReadHreftype( TLBContext *pcx, int offset )
     return niName.hreftype;
 }
 
+/* entries are at least 8 bytes long and are stored ordered by offset */
+static TLBString *find_string_by_offset(TLBString **table, UINT count, int offset)
+{
+    int min = 0, max = count - 1;
+
+    while (min <= max)
+    {
+        int i = (min + max) / 2;
+
+        if (table[i]->offset == offset)
+            return table[i];
+        if (table[i]->offset < offset)
+            min = i + 1;
+        else
+            max = i - 1;
+    }
+    return NULL;
+}
+
 static HRESULT MSFT_ReadAllNames(TLBContext *pcx)
 {
     char *string;
@@ -2167,6 +2201,10 @@ static HRESULT MSFT_ReadAllNames(TLBContext *pcx)
     INT16 len_piece;
     int offs = 0, lengthInChars;
 
+    pcx->names = heap_alloc(sizeof(TLBString *) * (max(pcx->pTblDir->pNametab.length, 0) / 8 + 1));
+    if (!pcx->names)
+        return E_OUTOFMEMORY;
+
     MSFT_Seek(pcx, pcx->pTblDir->pNametab.offset);
     while (1) {
         TLBString *tlbstr;
@@ -2202,6 +2240,7 @@ static HRESULT MSFT_ReadAllNames(TLBContext *pcx)
         heap_free(string);
 
         list_add_tail(&pcx->pLibInfo->name_list, &tlbstr->entry);
+        pcx->names[pcx->names_count++] = tlbstr;
 
         offs += len_piece;
     }
@@ -2209,30 +2248,20 @@ static HRESULT MSFT_ReadAllNames(TLBContext *pcx)
 
 static TLBString *MSFT_ReadName( TLBContext *pcx, int offset)
 {
-    TLBString *tlbstr;
-
-    LIST_FOR_EACH_ENTRY(tlbstr, &pcx->pLibInfo->name_list, TLBString, entry) {
-        if (tlbstr->offset == offset) {
-            TRACE_(typelib)("%s\n", debugstr_w(tlbstr->str));
-            return tlbstr;
-        }
-    }
+    TLBString *tlbstr = find_string_by_offset(pcx->names, pcx->names_count, offset);
 
-    return NULL;
+    if (tlbstr)
+        TRACE_(typelib)("%s\n", debugstr_w(tlbstr->str));
+    return tlbstr;
 }
 
 static TLBString *MSFT_ReadString( TLBContext *pcx, int offset)
 {
-    TLBString *tlbstr;
-
-    LIST_FOR_EACH_ENTRY(tlbstr, &pcx->pLibInfo->string_list, TLBString, entry) {
-        if (tlbstr->offset == offset) {
-            TRACE_(typelib)("%s\n", debugstr_w(tlbstr->str));
-            return tlbstr;
-        }
-    }
+    TLBString *tlbstr = find_string_by_offset(pcx->strings, pcx->strings_count, offset);
 
-    return NULL;
+    if (tlbstr)
+        TRACE_(typelib)("%s\n", debugstr_w(tlbstr->str));
+    return tlbstr;
 }
 
 /*
@@ -2793,6 +2822,10 @@ static HRESULT MSFT_ReadAllStrings(TLBContext *pcx)
     INT16 len_str, len_piece;
     int offs = 0, lengthInChars;
 
+    pcx->strings = heap_alloc(sizeof(TLBString *) * (max(pcx->pTblDir->pStringtab.length, 0) / 8 + 1));
+    if (!pcx->strings)
+        return E_OUTOFMEMORY;
+
     MSFT_Seek(pcx, pcx->pTblDir->pStringtab.offset);
     while (1) {
         TLBString *tlbstr;
@@ -2827,6 +2860,7 @@ static HRESULT MSFT_ReadAllStrings(TLBContext *pcx)
         heap_free(string);
 
         list_add_tail(&pcx->pLibInfo->string_list, &tlbstr->entry);
+        pcx->strings[pcx->strings_count++] = tlbstr;
 
         offs += len_piece;
     }
@@ -3493,6 +3527,9 @@ static ITypeLib2* ITypeLib2_Constructor_MSFT(LPVOID pLib, DWORD dwTLBLength)
     cx.mapping = pLib;
     cx.pLibInfo = pTypeLibImpl;
     cx.length = dwTLBLength;
+    cx.names = cx.strings = NULL;
+    cx.guids = NULL;
+    cx.names_count = cx.strings_count = cx.guids_count = 0;
 
     /* read header */
     MSFT_ReadLEDWords(&tlbHeader, sizeof(tlbHeader), &cx, 0);
@@ -3685,6 +3722,10 @@ static ITypeLib2* ITypeLib2_Constructor_MSFT(LPVOID pLib, DWORD dwTLBLength)
     }
 #endif
 
+    heap_free(cx.names);
+    heap_free(cx.strings);
+    heap_free(cx.guids);
+
     TRACE("(%p)\n", pTypeLibImpl);
     return &pTypeLibImpl->ITypeLib2_iface;
 }
@@ -5636,6 +5677,7 @@ static void ITypeInfoImpl_Destroy(ITypeInfoImpl *This)
         }
         heap_free(pFInfo->funcdesc.lprgelemdescParam);
         heap_free(pFInfo->pParamDesc);
+        heap_free(pFInfo->invoke_vts);
         TLB_FreeCustData(&pFInfo->custdata_list);
     }
     heap_free(This->funcdescs);
@@ -6884,6 +6926,59 @@ static inline BOOL func_restricted( const FUNCDESC *desc )
 #define INVBUF_GET_ARG_TYPE_ARRAY(buffer, params) \
     ((VARTYPE *)((char *)(buffer) + (sizeof(VARIANTARG) + sizeof(VARIANTARG) + sizeof(VARIANTARG *)) * (params)))
 
+/* Resolving the variant types may need to load referenced type infos, so
+ * compute them once per function and keep them for subsequent calls. The
+ * last entry is the type of the return value. */
+static HRESULT get_invoke_vts(ITypeInfoImpl *This, TLBFuncDesc *func, const VARTYPE **vts)
+{
+    const FUNCDESC *func_desc = &func->funcdesc;
+    VARTYPE *new_vts;
+    HRESULT hres;
+    int i;
+
+    if (func->invoke_vts)
+    {
+        *vts = func->invoke_vts;
+        return S_OK;
+    }
+
+    new_vts = heap_alloc_zero(sizeof(VARTYPE) * (func_desc->cParams + 1));
+    if (!new_vts)
+        return E_OUTOFMEMORY;
+
+    for (i = 0; i < func_desc->cParams; i++)
+    {
+        hres = typedescvt_to_variantvt((ITypeInfo *)&This->ITypeInfo2_iface,
+                                       &func_desc->lprgelemdescParam[i].tdesc, &new_vts[i]);
+        if (FAILED(hres))
+        {
+            heap_free(new_vts);
+            return hres;
+        }
+    }
+
+    /* VT_VOID is a special case for return types, so it is not
+     * handled in the general function */
+    if (func_desc->elemdescFunc.tdesc.vt == VT_VOID)
+        new_vts[func_desc->cParams] = VT_EMPTY;
+    else
+    {
+        hres = typedescvt_to_variantvt((ITypeInfo *)&This->ITypeInfo2_iface,
+                                       &func_desc->elemdescFunc.tdesc, &new_vts[func_desc->cParams]);
+        if (FAILED(hres))
+        {
+            heap_free(new_vts);
+            return hres;
+        }
+    }
+
+    if (InterlockedCompareExchangePointer((void **)&func->invoke_vts, new_vts, NULL))
+        heap_free(new_vts);
+
+    *vts = func->invoke_vts;
+    return S_OK;
+}
+
 static HRESULT WINAPI ITypeInfo_fnInvoke(
     ITypeInfo2 *iface,
     VOID  *pIUnk,
@@ -6899,7 +6994,7 @@ static HRESULT WINAPI ITypeInfo_fnInvoke(
     unsigned int var_index;
     TYPEKIND type_kind;
     HRESULT hres;
-    const TLBFuncDesc *pFuncInfo;
+    TLBFuncDesc *pFuncInfo;
     UINT fdc;
 
     TRACE("(%p)(%p,id=%d,flags=0x%08x,%p,%p,%p,%p)\n",
@@ -6955,6 +7050,7 @@ static HRESULT WINAPI ITypeInfo_fnInvoke(
             UINT cNamedArgs = pDispParams->cNamedArgs;
             DISPID *rgdispidNamedArgs = pDispParams->rgdispidNamedArgs;
             UINT vargs_converted=0;
+            const VARTYPE *invoke_vts;
 
             hres = S_OK;
 
@@ -6975,13 +7071,10 @@ static HRESULT WINAPI ITypeInfo_fnInvoke(
                 goto func_fail;
             }
 
-            for (i = 0; i < func_desc->cParams; i++)
-            {
-                TYPEDESC *tdesc = &func_desc->lprgelemdescParam[i].tdesc;
-                hres = typedescvt_to_variantvt((ITypeInfo *)iface, tdesc, &rgvt[i]);
-                if (FAILED(hres))
-                    goto func_fail;
-            }
+            hres = get_invoke_vts(This, pFuncInfo, &invoke_vts);
+            if (FAILED(hres))
+                goto func_fail;
+            memcpy(rgvt, invoke_vts, sizeof(VARTYPE) * func_desc->cParams);
 
             TRACE("changing args\n");
             for (i = 0; i < func_desc->cParams; i++)
@@ -7198,16 +7291,7 @@ static HRESULT WINAPI ITypeInfo_fnInvoke(
             }
             if (FAILED(hres)) goto func_fail; /* FIXME: we don't free changed types here */
 
-            /* VT_VOID is a special case for return types, so it is not
-             * handled in the general function */
-            if (func_desc->elemdescFunc.tdesc.vt == VT_VOID)
-                V_VT(&varresult) = VT_EMPTY;
-            else
-            {
-                V_VT(&varresult) = 0;
-                hres = typedescvt_to_variantvt((ITypeInfo *)iface, &func_desc->elemdescFunc.tdesc, &V_VT(&varresult));
-                if (FAILED(hres)) goto func_fail; /* FIXME: we don't free changed types here */
-            }
+            V_VT(&varresult) = invoke_vts[func_desc->cParams];
 
             hres = DispCallFunc(pIUnk, func_desc->oVft & 0xFFFC, func_desc->callconv,
                                 V_VT(&varresult), func_desc->cParams, rgvt,
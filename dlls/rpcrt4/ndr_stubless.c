@@ -474,6 +474,32 @@ void client_do_args( PMIDL_STUB_MESSAGE pStubMsg, PFORMAT_STRING pFormat, enum s
     }
 }
 
+/* Calculate the buffer size needed for the [in] parameters. When the stub
+ * compiler was able to compute it at compile time the sizing pass over the
+ * parameters is skipped, only null reference pointers are checked for. */
+static void client_calc_size( PMIDL_STUB_MESSAGE pStubMsg, PFORMAT_STRING pFormat,
+                              const NDR_PROC_PARTIAL_OIF_HEADER *pOIFHeader, void **fpu_args,
+                              unsigned short number_of_params, unsigned char *pRetVal )
+{
+    const NDR_PARAM_OIF *params = (const NDR_PARAM_OIF *)pFormat;
+    unsigned int i;
+
+    if (!pOIFHeader || pOIFHeader->Oi2Flags.ClientMustSize)
+    {
+        client_do_args( pStubMsg, pFormat, STUBLESS_CALCSIZE, fpu_args, number_of_params, pRetVal );
+        return;
+    }
+
+    for (i = 0; i < number_of_params; i++)
+    {
+        unsigned char *pArg = pStubMsg->StackTop + params[i].stack_offset;
+        if (params[i].attr.IsSimpleRef && !*(unsigned char **)pArg)
+            RpcRaiseException(RPC_X_NULL_REF_POINTER);
+    }
+    TRACE( "using constant buffer size %u\n", pOIFHeader->constant_client_buffer_size );
+    pStubMsg->BufferLength += pOIFHeader->constant_client_buffer_size;
+}
+
 static unsigned int type_stack_size(unsigned char fc)
 {
     switch (fc)
@@ -617,6 +643,8 @@ LONG_PTR CDECL ndr_client_call( PMIDL_STUB_DESC pStubDesc, PFORMAT_STRING pForma
     /* the pointer to the object when in OLE mode */
     void * This = NULL;
     PFORMAT_STRING pHandleFormat;
+    /* -Oicf procedure header, if any */
+    const NDR_PROC_PARTIAL_OIF_HEADER *pOIFHeader = NULL;
     /* correlation cache */
     ULONG_PTR NdrCorrCache[256];
 
@@ -668,8 +696,7 @@ LONG_PTR CDECL ndr_client_call( PMIDL_STUB_DESC pStubDesc, PFORMAT_STRING pForma
 
     if (pStubDesc->Version >= 0x20000)  /* -Oicf format */
     {
-        const NDR_PROC_PARTIAL_OIF_HEADER *pOIFHeader =
-            (const NDR_PROC_PARTIAL_OIF_HEADER *)pFormat;
+        pOIFHeader = (const NDR_PROC_PARTIAL_OIF_HEADER *)pFormat;
 
         Oif_flags = pOIFHeader->Oi2Flags;
         number_of_params = pOIFHeader->number_of_params;
@@ -753,8 +780,8 @@ LONG_PTR CDECL ndr_client_call( PMIDL_STUB_DESC pStubDesc, PFORMAT_STRING pForma
         {
             /* 2. CALCSIZE */
             TRACE( "CALCSIZE\n" );
-            client_do_args(&stubMsg, pFormat, STUBLESS_CALCSIZE, fpu_stack,
-                           number_of_params, (unsigned char *)&RetVal);
+            client_calc_size(&stubMsg, pFormat, pOIFHeader, fpu_stack,
+                             number_of_params, (unsigned char *)&RetVal);
 
             /* 3. GETBUFFER */
             TRACE( "GETBUFFER\n" );
@@ -867,8 +894,8 @@ LONG_PTR CDECL ndr_client_call( PMIDL_STUB_DESC pStubDesc, PFORMAT_STRING pForma
     {
         /* 2. CALCSIZE */
         TRACE( "CALCSIZE\n" );
-        client_do_args(&stubMsg, pFormat, STUBLESS_CALCSIZE, fpu_stack,
-                       number_of_params, (unsigned char *)&RetVal);
+        client_calc_size(&stubMsg, pFormat, pOIFHeader, fpu_stack,
+                         number_of_params, (unsigned char *)&RetVal);
 
         /* 3. GETBUFFER */
         TRACE( "GETBUFFER\n" );
@@ -1208,6 +1235,8 @@ LONG WINAPI NdrStubCall2(
     INTERPRETER_OPT_FLAGS Oif_flags = { 0 };
     /* cache of extension flags from NDR_PROC_HEADER_EXTS */
     INTERPRETER_OPT_FLAGS2 ext_flags = { 0 };
+    /* -Oicf procedure header, if any */
+    const NDR_PROC_PARTIAL_OIF_HEADER *pOIFHeader = NULL;
     /* the type of pass we are currently doing */
     enum stubless_phase phase;
     /* header for procedure string */
@@ -1309,7 +1338,7 @@ LONG WINAPI NdrStubCall2(
 
     if (pStubDesc->Version >= 0x20000)  /* -Oicf format */
     {
-        const NDR_PROC_PARTIAL_OIF_HEADER *pOIFHeader = (const NDR_PROC_PARTIAL_OIF_HEADER *)pFormat;
+        pOIFHeader = (const NDR_PROC_PARTIAL_OIF_HEADER *)pFormat;
 
         Oif_flags = pOIFHeader->Oi2Flags;
         number_of_params = pOIFHeader->number_of_params;
@@ -1405,9 +1434,16 @@ LONG WINAPI NdrStubCall2(
                 stubMsg.Buffer = pRpcMsg->Buffer;
             }
             break;
+        case STUBLESS_CALCSIZE:
+            /* the stub compiler already computed the size of the [out] params */
+            if (pOIFHeader && !pOIFHeader->Oi2Flags.ServerMustSize)
+            {
+                stubMsg.BufferLength = pOIFHeader->constant_server_buffer_size;
+                break;
+            }
+            /* fall through */
         case STUBLESS_UNMARSHAL:
         case STUBLESS_INITOUT:
-        case STUBLESS_CALCSIZE:
         case STUBLESS_MARSHAL:
         case STUBLESS_FREE:
             retval_ptr = stub_do_args(&stubMsg, pFormat, phase, number_of_params);
@@ -1500,6 +1536,8 @@ LONG_PTR CDECL ndr_async_client_call( PMIDL_STUB_DESC pStubDesc, PFORMAT_STRING
     const NDR_PROC_HEADER * pProcHeader = (const NDR_PROC_HEADER *)&pFormat[0];
     /* -Oif or -Oicf generated format */
     BOOL bV2Format = FALSE;
+    /* -Oicf procedure header, if any */
+    const NDR_PROC_PARTIAL_OIF_HEADER *pOIFHeader = NULL;
     RPC_STATUS status;
 
     TRACE("pStubDesc %p, pFormat %p, ...\n", pStubDesc, pFormat);
@@ -1565,8 +1603,7 @@ LONG_PTR CDECL ndr_async_client_call( PMIDL_STUB_DESC pStubDesc, PFORMAT_STRING
 
     if (bV2Format)
     {
-        const NDR_PROC_PARTIAL_OIF_HEADER *pOIFHeader =
-            (const NDR_PROC_PARTIAL_OIF_HEADER *)pFormat;
+        pOIFHeader = (const NDR_PROC_PARTIAL_OIF_HEADER *)pFormat;
 
         Oif_flags = pOIFHeader->Oi2Flags;
         async_call_data->number_of_params = pOIFHeader->number_of_params;
@@ -1628,7 +1665,7 @@ LONG_PTR CDECL ndr_async_client_call( PMIDL_STUB_DESC pStubDesc, PFORMAT_STRING
 
     /* 1. CALCSIZE */
     TRACE( "CALCSIZE\n" );
-    client_do_args(pStubMsg, pFormat, STUBLESS_CALCSIZE, NULL, async_call_data->number_of_params, NULL);
+    client_calc_size(pStubMsg, pFormat, pOIFHeader, NULL, async_call_data->number_of_params, NULL);
 
     /* 2. GETBUFFER */
     TRACE( "GETBUFFER\n" );
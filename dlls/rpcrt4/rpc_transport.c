@@ -115,6 +115,9 @@ typedef struct _RpcConnection_np
   HANDLE pipe;
   HANDLE listen_thread;
   BOOL listening;
+  char *read_buf;          /* data read from the pipe but not yet consumed */
+  unsigned int read_pos;
+  unsigned int read_len;
 } RpcConnection_np;
 
 static RpcConnection *rpcrt4_conn_np_alloc(void)
@@ -372,6 +375,7 @@ static void rpcrt4_conn_np_handoff(RpcConnection_np *old_npc, RpcConnection_np *
   old_npc->pipe = 0;
   old_npc->listen_thread = 0;
   old_npc->listening = FALSE;
+  old_npc->read_pos = old_npc->read_len = 0;
 }
 
 static RPC_STATUS rpcrt4_ncacn_np_handoff(RpcConnection *old_conn, RpcConnection *new_conn)
@@ -408,6 +412,10 @@ static RPC_STATUS rpcrt4_ncalrpc_handoff(RpcConnection *old_conn, RpcConnection
   return status;
 }
 
+/* Packets are read in several small pieces (common header, rest of the
+ * header, payload), so read ahead into a buffer to avoid a pipe round trip
+ * for each of them. Reads at least as large as the buffer go directly into
+ * the caller's memory. */
 static int rpcrt4_conn_np_read(RpcConnection *Connection,
                         void *buffer, unsigned int count)
 {
@@ -416,9 +424,37 @@ static int rpcrt4_conn_np_read(RpcConnection *Connection,
   BOOL ret = TRUE;
   unsigned int bytes_left = count;
 
+  if (npc->read_len)
+  {
+    unsigned int len = min(npc->read_len, bytes_left);
+    memcpy(buf, npc->read_buf + npc->read_pos, len);
+    npc->read_pos += len;
+    npc->read_len -= len;
+    bytes_left -= len;
+    buf += len;
+  }
+
   while (bytes_left)
   {
     DWORD bytes_read;
+
+    if (bytes_left < RPC_MAX_PACKET_SIZE)
+    {
+      if (!npc->read_buf && !(npc->read_buf = HeapAlloc(GetProcessHeap(), 0, RPC_MAX_PACKET_SIZE)))
+        return -1;
+      ret = ReadFile(npc->pipe, npc->read_buf, RPC_MAX_PACKET_SIZE, &bytes_read, NULL);
+      if (!ret && GetLastError() == ERROR_MORE_DATA)
+          ret = TRUE;
+      if (!ret || !bytes_read)
+          break;
+      npc->read_pos = min(bytes_read, bytes_left);
+      npc->read_len = bytes_read - npc->read_pos;
+      memcpy(buf, npc->read_buf, npc->read_pos);
+      bytes_left -= npc->read_pos;
+      buf += npc->read_pos;
+      continue;
+    }
+
     ret = ReadFile(npc->pipe, buf, bytes_left, &bytes_read, NULL);
     if (!ret && GetLastError() == ERROR_MORE_DATA)
         ret = TRUE;
@@ -462,6 +498,9 @@ static int rpcrt4_conn_np_close(RpcConnection *Connection)
     CloseHandle(npc->listen_thread);
     npc->listen_thread = 0;
   }
+  HeapFree(GetProcessHeap(), 0, npc->read_buf);
+  npc->read_buf = NULL;
+  npc->read_pos = npc->read_len = 0;
   return 0;
 }
 
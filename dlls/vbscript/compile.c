@@ -1322,6 +1322,70 @@ static HRESULT fill_array_desc(compile_ctx_t *ctx, dim_decl_t *dim_decl, array_d
     return S_OK;
 }
 
+/* Binds identifier operands that refer to local variables or arguments to their slots,
+ * so that the interpreter doesn't need to look them up by name. */
+static HRESULT resolve_local_refs(compile_ctx_t *ctx, function_t *func)
+{
+    const WCHAR *name;
+    local_ref_t *ref;
+    instr_t *instr;
+    unsigned i, j;
+
+    if(!func->var_cnt && !func->arg_cnt)
+        return S_OK;
+
+    func->local_refs = compiler_alloc(ctx->code, (ctx->instr_cnt-func->code_off) * sizeof(local_ref_t));
+    if(!func->local_refs)
+        return E_OUTOFMEMORY;
+
+    for(i = func->code_off; i < ctx->instr_cnt; i++) {
+        instr = ctx->code->instrs + i;
+        ref = func->local_refs + (i-func->code_off);
+
+        switch(instr->op) {
+        case OP_assign_ident:
+        case OP_const:
+        case OP_dim:
+        case OP_icall:
+        case OP_icallv:
+        case OP_incc:
+        case OP_set_ident:
+            name = instr->arg1.bstr;
+            break;
+        case OP_enumnext:
+        case OP_step:
+            name = instr->arg2.bstr;
+            break;
+        default:
+            ref->name = NULL;
+            continue;
+        }
+
+        ref->name = name;
+        ref->type = LOCAL_REF_NONE;
+
+        for(j = 0; j < func->var_cnt; j++) {
+            if(!strcmpiW(func->vars[j].name, name)) {
+                ref->type = LOCAL_REF_VAR;
+                ref->idx = j;
+                break;
+            }
+        }
+        if(ref->type != LOCAL_REF_NONE)
+            continue;
+
+        for(j = 0; j < func->arg_cnt; j++) {
+            if(!strcmpiW(func->args[j].name, name)) {
+                ref->type = LOCAL_REF_ARG;
+                ref->idx = j;
+                break;
+            }
+        }
+    }
+
+    return S_OK;
+}
+
 static HRESULT compile_func(compile_ctx_t *ctx, statement_t *stat, function_t *func)
 {
     HRESULT hres;
@@ -1434,7 +1498,7 @@ static HRESULT compile_func(compile_ctx_t *ctx, statement_t *stat, function_t *f
         assert(array_id == func->array_cnt);
     }
 
-    return S_OK;
+    return resolve_local_refs(ctx, func);
 }
 
 static BOOL lookup_funcs_name(compile_ctx_t *ctx, const WCHAR *name)
@@ -1469,6 +1533,7 @@ static HRESULT create_function(compile_ctx_t *ctx, function_decl_t *decl, functi
 
     func->vars = NULL;
     func->var_cnt = 0;
+    func->local_refs = NULL;
     func->array_cnt = 0;
     func->code_ctx = ctx->code;
     func->type = decl->type;
@@ -1788,6 +1853,7 @@ static vbscode_t *alloc_vbscode(compile_ctx_t *ctx, const WCHAR *source)
     ret->main_code.name = NULL;
     ret->main_code.code_ctx = ret;
     ret->main_code.vars = NULL;
+    ret->main_code.local_refs = NULL;
     ret->main_code.var_cnt = 0;
     ret->main_code.array_cnt = 0;
     ret->main_code.arg_cnt = 0;
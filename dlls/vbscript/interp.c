@@ -113,6 +113,25 @@ static HRESULT lookup_identifier(exec_ctx_t *ctx, BSTR name, vbdisp_invoke_type_
         return S_OK;
     }
 
+    if(ctx->func->local_refs) {
+        const local_ref_t *local_ref = ctx->func->local_refs + (ctx->instr - ctx->code->instrs - ctx->func->code_off);
+
+        if(local_ref->name == name) {
+            switch(local_ref->type) {
+            case LOCAL_REF_VAR:
+                ref->type = REF_VAR;
+                ref->u.v = ctx->vars+local_ref->idx;
+                return S_OK;
+            case LOCAL_REF_ARG:
+                ref->type = REF_VAR;
+                ref->u.v = ctx->args+local_ref->idx;
+                return S_OK;
+            case LOCAL_REF_NONE:
+                goto nonlocal;
+            }
+        }
+    }
+
     for(i=0; i < ctx->func->var_cnt; i++) {
         if(!strcmpiW(ctx->func->vars[i].name, name)) {
             ref->type = REF_VAR;
@@ -129,6 +148,7 @@ static HRESULT lookup_identifier(exec_ctx_t *ctx, BSTR name, vbdisp_invoke_type_
         }
     }
 
+nonlocal:
     if(lookup_dynamic_vars(ctx->func->type == FUNC_GLOBAL ? ctx->script->global_vars : ctx->dynamic_vars, name, ref))
         return S_OK;
 
@@ -1496,10 +1516,84 @@ static HRESULT interp_imp(exec_ctx_t *ctx)
     return stack_push(ctx, &v);
 }
 
+static inline BOOL get_num_val(const VARIANT *v, DOUBLE *ret)
+{
+    switch(V_VT(v)) {
+    case VT_I2:
+        *ret = V_I2(v);
+        return TRUE;
+    case VT_I4:
+        *ret = V_I4(v);
+        return TRUE;
+    case VT_R8:
+        *ret = V_R8(v);
+        return TRUE;
+    default:
+        return FALSE;
+    }
+}
+
+static inline BOOL get_int_vals(const VARIANT *l, const VARIANT *r, LONG *lval, LONG *rval)
+{
+    switch(V_VT(l)) {
+    case VT_I2:
+        *lval = V_I2(l);
+        break;
+    case VT_I4:
+        *lval = V_I4(l);
+        break;
+    default:
+        return FALSE;
+    }
+
+    switch(V_VT(r)) {
+    case VT_I2:
+        *rval = V_I2(r);
+        break;
+    case VT_I4:
+        *rval = V_I4(r);
+        break;
+    default:
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/* Stores result of integer arithmetic using the same result type as oleaut32 would.
+ * Returns FALSE on overflow, in which case the caller should fall back to Var* functions. */
+static inline BOOL set_int_result(const VARIANT *l, const VARIANT *r, LONGLONG val, VARIANT *ret)
+{
+    if(V_VT(l) == VT_I2 && V_VT(r) == VT_I2 && val >= -0x8000 && val <= 0x7fff) {
+        V_VT(ret) = VT_I2;
+        V_I2(ret) = val;
+        return TRUE;
+    }
+
+    if(val >= INT32_MIN && val <= INT32_MAX) {
+        V_VT(ret) = VT_I4;
+        V_I4(ret) = val;
+        return TRUE;
+    }
+
+    return FALSE;
+}
+
 static HRESULT var_cmp(exec_ctx_t *ctx, VARIANT *l, VARIANT *r)
 {
+    DOUBLE lval, rval;
+
     TRACE("%s %s\n", debugstr_variant(l), debugstr_variant(r));
 
+    if(get_num_val(l, &lval) && get_num_val(r, &rval)) {
+        if(lval < rval)
+            return VARCMP_LT;
+        if(lval > rval)
+            return VARCMP_GT;
+        if(lval == rval)
+            return VARCMP_EQ;
+    }
+
     /* FIXME: Fix comparing string to number */
 
     return VarCmp(l, r, ctx->script->lcid, 0);
@@ -1730,6 +1824,25 @@ static HRESULT interp_is(exec_ctx_t *ctx)
     return stack_push(ctx, &v);
 }
 
+static HRESULT concat_bstrs(BSTR l, BSTR r, VARIANT *ret)
+{
+    unsigned l_len = SysStringLen(l), r_len = SysStringLen(r);
+    BSTR str;
+
+    str = SysAllocStringLen(NULL, l_len+r_len);
+    if(!str)
+        return E_OUTOFMEMORY;
+
+    if(l_len)
+        memcpy(str, l, l_len*sizeof(WCHAR));
+    if(r_len)
+        memcpy(str+l_len, r, r_len*sizeof(WCHAR));
+
+    V_VT(ret) = VT_BSTR;
+    V_BSTR(ret) = str;
+    return S_OK;
+}
+
 static HRESULT interp_concat(exec_ctx_t *ctx)
 {
     variant_val_t r, l;
@@ -1744,7 +1857,10 @@ static HRESULT interp_concat(exec_ctx_t *ctx)
 
     hres = stack_pop_val(ctx, &l);
     if(SUCCEEDED(hres)) {
-        hres = VarCat(l.v, r.v, &v);
+        if(V_VT(l.v) == VT_BSTR && V_VT(r.v) == VT_BSTR)
+            hres = concat_bstrs(V_BSTR(l.v), V_BSTR(r.v), &v);
+        else
+            hres = VarCat(l.v, r.v, &v);
         release_val(&l);
     }
     release_val(&r);
@@ -1757,6 +1873,7 @@ static HRESULT interp_concat(exec_ctx_t *ctx)
 static HRESULT interp_add(exec_ctx_t *ctx)
 {
     variant_val_t r, l;
+    LONG lval, rval;
     VARIANT v;
     HRESULT hres;
 
@@ -1768,7 +1885,14 @@ static HRESULT interp_add(exec_ctx_t *ctx)
 
     hres = stack_pop_val(ctx, &l);
     if(SUCCEEDED(hres)) {
-        hres = VarAdd(l.v, r.v, &v);
+        if(get_int_vals(l.v, r.v, &lval, &rval) && set_int_result(l.v, r.v, (LONGLONG)lval + rval, &v))
+            hres = S_OK;
+        else if(V_VT(l.v) == VT_R8 && V_VT(r.v) == VT_R8) {
+            V_VT(&v) = VT_R8;
+            V_R8(&v) = V_R8(l.v) + V_R8(r.v);
+            hres = S_OK;
+        }else
+            hres = VarAdd(l.v, r.v, &v);
         release_val(&l);
     }
     release_val(&r);
@@ -1781,6 +1905,7 @@ static HRESULT interp_add(exec_ctx_t *ctx)
 static HRESULT interp_sub(exec_ctx_t *ctx)
 {
     variant_val_t r, l;
+    LONG lval, rval;
     VARIANT v;
     HRESULT hres;
 
@@ -1792,7 +1917,14 @@ static HRESULT interp_sub(exec_ctx_t *ctx)
 
     hres = stack_pop_val(ctx, &l);
     if(SUCCEEDED(hres)) {
-        hres = VarSub(l.v, r.v, &v);
+        if(get_int_vals(l.v, r.v, &lval, &rval) && set_int_result(l.v, r.v, (LONGLONG)lval - rval, &v))
+            hres = S_OK;
+        else if(V_VT(l.v) == VT_R8 && V_VT(r.v) == VT_R8) {
+            V_VT(&v) = VT_R8;
+            V_R8(&v) = V_R8(l.v) - V_R8(r.v);
+            hres = S_OK;
+        }else
+            hres = VarSub(l.v, r.v, &v);
         release_val(&l);
     }
     release_val(&r);
@@ -1877,6 +2009,7 @@ static HRESULT interp_div(exec_ctx_t *ctx)
 static HRESULT interp_mul(exec_ctx_t *ctx)
 {
     variant_val_t r, l;
+    LONG lval, rval;
     VARIANT v;
     HRESULT hres;
 
@@ -1888,7 +2021,14 @@ static HRESULT interp_mul(exec_ctx_t *ctx)
 
     hres = stack_pop_val(ctx, &l);
     if(SUCCEEDED(hres)) {
-        hres = VarMul(l.v, r.v, &v);
+        if(get_int_vals(l.v, r.v, &lval, &rval) && set_int_result(l.v, r.v, (LONGLONG)lval * rval, &v))
+            hres = S_OK;
+        else if(V_VT(l.v) == VT_R8 && V_VT(r.v) == VT_R8) {
+            V_VT(&v) = VT_R8;
+            V_R8(&v) = V_R8(l.v) * V_R8(r.v);
+            hres = S_OK;
+        }else
+            hres = VarMul(l.v, r.v, &v);
         release_val(&l);
     }
     release_val(&r);
@@ -2557,8 +2557,39 @@ ExecuteREBytecode(REGlobalData *gData, match_state_t *x)
      * until that match is made, or fail if it can't be found at all.
      */
     if (REOP_IS_SIMPLE(op) && !(gData->regexp->flags & REG_STICKY)) {
+        BOOL has_first_ch = TRUE;
+        WCHAR first_ch = 0;
+
+        /*
+         * If the pattern starts with a case sensitive literal, find the
+         * candidate positions with memchrW instead of trying each of them.
+         */
+        switch (op) {
+          case REOP_FLAT:
+            ReadCompactIndex(pc, &k);
+            first_ch = gData->regexp->source[k];
+            break;
+          case REOP_FLAT1:
+            first_ch = *pc;
+            break;
+          case REOP_UCFLAT1:
+            first_ch = GET_ARG(pc);
+            break;
+          default:
+            has_first_ch = FALSE;
+        }
+
         anchor = FALSE;
         while (x->cp <= gData->cpend) {
+            if (has_first_ch) {
+                const WCHAR *next = memchrW(x->cp, first_ch, gData->cpend - x->cp);
+
+                if (!next)
+                    next = gData->cpend;
+                gData->skipped += next - x->cp;
+                x->cp = next;
+            }
+
             nextpc = pc;    /* reset back to start each time */
             result = SimpleMatch(gData, x, op, &nextpc, TRUE);
             if (result) {
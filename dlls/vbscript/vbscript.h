@@ -316,6 +316,18 @@ typedef struct {
     const WCHAR *name;
 } var_desc_t;
 
+typedef enum {
+    LOCAL_REF_NONE,
+    LOCAL_REF_VAR,
+    LOCAL_REF_ARG
+} local_ref_type_t;
+
+typedef struct {
+    const WCHAR *name;
+    local_ref_type_t type;
+    unsigned idx;
+} local_ref_t;
+
 struct _function_t {
     function_type_t type;
     const WCHAR *name;
@@ -327,6 +339,7 @@ struct _function_t {
     array_desc_t *array_descs;
     unsigned array_cnt;
     unsigned code_off;
+    local_ref_t *local_refs;
     vbscode_t *code_ctx;
     function_t *next;
 };
@@ -949,6 +949,8 @@ HRESULT CDECL wined3d_buffer_map(struct wined3d_buffer *buffer, UINT offset, UIN
 
     TRACE("buffer %p, offset %u, size %u, data %p, flags %#x\n", buffer, offset, size, data, flags);
 
+    buffer->resource.device->cs->ops->finish(buffer->resource.device->cs);
+
     flags = wined3d_resource_sanitize_map_flags(&buffer->resource, flags);
     /* Filter redundant WINED3D_MAP_DISCARD maps. The 3DMark2001 multitexture
      * fill rate test seems to depend on this. When we map a buffer with
@@ -1058,6 +1060,8 @@ void CDECL wined3d_buffer_unmap(struct wined3d_buffer *buffer)
 
     TRACE("buffer %p.\n", buffer);
 
+    buffer->resource.device->cs->ops->finish(buffer->resource.device->cs);
+
     /* In the case that the number of Unmap calls > the
      * number of Map calls, d3d returns always D3D_OK.
      * This is also needed to prevent Map from returning garbage on
@@ -21,11 +21,19 @@
 #include "wined3d_private.h"
 
 WINE_DEFAULT_DEBUG_CHANNEL(d3d);
+WINE_DECLARE_DEBUG_CHANNEL(d3d_perf);
 
 #define WINED3D_INITIAL_CS_SIZE 4096
+#define WINED3D_CS_PACKET_ALIGN 16
+#define WINED3D_CS_SPIN_COUNT   10000
+#define WINED3D_CS_MAX_PRESENTS 2
+#define WINED3D_CS_STATS_FRAMES 256
 
 enum wined3d_cs_op
 {
+    WINED3D_CS_OP_NOP,
+    WINED3D_CS_OP_SYNC,
+    WINED3D_CS_OP_STOP,
     WINED3D_CS_OP_PRESENT,
     WINED3D_CS_OP_CLEAR,
     WINED3D_CS_OP_DRAW,
@@ -48,7 +56,30 @@ enum wined3d_cs_op
     WINED3D_CS_OP_SET_TRANSFORM,
     WINED3D_CS_OP_SET_CLIP_PLANE,
     WINED3D_CS_OP_SET_MATERIAL,
+    WINED3D_CS_OP_SET_CONSTS,
+    WINED3D_CS_OP_SET_LIGHT,
+    WINED3D_CS_OP_SET_LIGHT_ENABLE,
+    WINED3D_CS_OP_SET_PRIMITIVE_TYPE,
+    WINED3D_CS_OP_UNBIND_RESOURCES,
     WINED3D_CS_OP_RESET_STATE,
+    WINED3D_CS_OP_QUERY_ISSUE,
+    WINED3D_CS_OP_QUERY_GET_DATA,
+};
+
+struct wined3d_cs_packet
+{
+    size_t size;
+    BYTE data[1];
+};
+
+struct wined3d_cs_sync
+{
+    enum wined3d_cs_op opcode;
+};
+
+struct wined3d_cs_stop
+{
+    enum wined3d_cs_op opcode;
 };
 
 struct wined3d_cs_present
@@ -56,26 +87,30 @@ struct wined3d_cs_present
     enum wined3d_cs_op opcode;
     HWND dst_window_override;
     struct wined3d_swapchain *swapchain;
-    const RECT *src_rect;
-    const RECT *dst_rect;
-    const RGNDATA *dirty_region;
+    BOOL src_rect_valid;
+    RECT src_rect;
+    BOOL dst_rect_valid;
+    RECT dst_rect;
     DWORD flags;
+    BOOL dirty_region_valid;
+    RGNDATA dirty_region;
 };
 
 struct wined3d_cs_clear
 {
     enum wined3d_cs_op opcode;
-    DWORD rect_count;
-    const RECT *rects;
     DWORD flags;
-    const struct wined3d_color *color;
+    struct wined3d_color color;
     float depth;
     DWORD stencil;
+    DWORD rect_count;
+    RECT rects[1];
 };
 
 struct wined3d_cs_draw
 {
     enum wined3d_cs_op opcode;
+    INT base_vertex_idx;
     UINT start_idx;
     UINT index_count;
     UINT start_instance;
@@ -86,13 +121,13 @@ struct wined3d_cs_draw
 struct wined3d_cs_set_viewport
 {
     enum wined3d_cs_op opcode;
-    const struct wined3d_viewport *viewport;
+    struct wined3d_viewport viewport;
 };
 
 struct wined3d_cs_set_scissor_rect
 {
     enum wined3d_cs_op opcode;
-    const RECT *rect;
+    RECT rect;
 };
 
 struct wined3d_cs_set_render_target
@@ -203,20 +238,53 @@ struct wined3d_cs_set_transform
 {
     enum wined3d_cs_op opcode;
     enum wined3d_transform_state state;
-    const struct wined3d_matrix *matrix;
+    struct wined3d_matrix matrix;
 };
 
 struct wined3d_cs_set_clip_plane
 {
     enum wined3d_cs_op opcode;
     UINT plane_idx;
-    const struct wined3d_vec4 *plane;
+    struct wined3d_vec4 plane;
 };
 
 struct wined3d_cs_set_material
 {
     enum wined3d_cs_op opcode;
-    const struct wined3d_material *material;
+    struct wined3d_material material;
+};
+
+struct wined3d_cs_set_consts
+{
+    enum wined3d_cs_op opcode;
+    DWORD constant_type;
+    UINT start_register;
+    UINT count;
+    DWORD constants[1];
+};
+
+struct wined3d_cs_set_light
+{
+    enum wined3d_cs_op opcode;
+    struct wined3d_light_info light;
+};
+
+struct wined3d_cs_set_light_enable
+{
+    enum wined3d_cs_op opcode;
+    UINT light_idx;
+    BOOL enable;
+};
+
+struct wined3d_cs_set_primitive_type
+{
+    enum wined3d_cs_op opcode;
+    GLenum gl_primitive_type;
+};
+
+struct wined3d_cs_unbind_resources
+{
+    enum wined3d_cs_op opcode;
 };
 
 struct wined3d_cs_reset_state
@@ -224,6 +292,40 @@ struct wined3d_cs_reset_state
     enum wined3d_cs_op opcode;
 };
 
+struct wined3d_cs_query_issue
+{
+    enum wined3d_cs_op opcode;
+    struct wined3d_query *query;
+    DWORD flags;
+};
+
+struct wined3d_cs_query_get_data
+{
+    enum wined3d_cs_op opcode;
+    struct wined3d_query *query;
+    void *data;
+    DWORD data_size;
+    DWORD flags;
+    HRESULT *hr;
+};
+
+static void wined3d_cs_exec_nop(struct wined3d_cs *cs, const void *data)
+{
+}
+
+static void wined3d_cs_exec_sync(struct wined3d_cs *cs, const void *data)
+{
+    struct wined3d_context *context;
+
+    /* Other threads read or map the same GL objects through their own
+     * contexts once we signal. Shared object rules require the commands
+     * to have completed by then, glFlush() only guarantees they will. */
+    if ((context = context_get_current()))
+        context->gl_info->gl_ops.gl.p_glFinish();
+
+    SetEvent(cs->finish_event);
+}
+
 static void wined3d_cs_exec_present(struct wined3d_cs *cs, const void *data)
 {
     const struct wined3d_cs_present *op = data;
@@ -233,7 +335,28 @@ static void wined3d_cs_exec_present(struct wined3d_cs *cs, const void *data)
     wined3d_swapchain_set_window(swapchain, op->dst_window_override);
 
     swapchain->swapchain_ops->swapchain_present(swapchain,
-            op->src_rect, op->dst_rect, op->dirty_region, op->flags);
+            op->src_rect_valid ? &op->src_rect : NULL,
+            op->dst_rect_valid ? &op->dst_rect : NULL,
+            op->dirty_region_valid ? &op->dirty_region : NULL, op->flags);
+
+    InterlockedDecrement(&cs->pending_presents);
+}
+
+/* Block the application thread until the command stream thread has retired
+ * at least one more packet since "tail" was read. */
+static void wined3d_cs_wait_retire(struct wined3d_cs *cs, LONG tail)
+{
+    InterlockedExchange(&cs->retire_waiting, TRUE);
+    if (*(volatile LONG *)&cs->queue.tail == tail)
+        WaitForSingleObject(cs->retire_event, INFINITE);
+    InterlockedExchange(&cs->retire_waiting, FALSE);
+}
+
+static void wined3d_cs_dump_stats(const struct wined3d_cs *cs)
+{
+    TRACE_(d3d_perf)("%u packets, max queue depth %u bytes, %u queue stalls, %u present stalls, %u syncs.\n",
+            cs->stats.packet_count, cs->stats.max_depth, cs->stats.stall_count,
+            cs->stats.present_stall_count, cs->stats.finish_count);
 }
 
 void wined3d_cs_emit_present(struct wined3d_cs *cs, struct wined3d_swapchain *swapchain,
@@ -241,17 +364,49 @@ void wined3d_cs_emit_present(struct wined3d_cs *cs, struct wined3d_swapchain *sw
         const RGNDATA *dirty_region, DWORD flags)
 {
     struct wined3d_cs_present *op;
+    size_t size = sizeof(*op);
 
-    op = cs->ops->require_space(cs, sizeof(*op));
+    if (dirty_region)
+        size = max(size, FIELD_OFFSET(struct wined3d_cs_present, dirty_region.Buffer[dirty_region->rdh.nRgnSize]));
+
+    op = cs->ops->require_space(cs, size);
     op->opcode = WINED3D_CS_OP_PRESENT;
     op->dst_window_override = dst_window_override;
     op->swapchain = swapchain;
-    op->src_rect = src_rect;
-    op->dst_rect = dst_rect;
-    op->dirty_region = dirty_region;
+    if ((op->src_rect_valid = !!src_rect))
+        op->src_rect = *src_rect;
+    if ((op->dst_rect_valid = !!dst_rect))
+        op->dst_rect = *dst_rect;
     op->flags = flags;
+    if ((op->dirty_region_valid = !!dirty_region))
+        memcpy(&op->dirty_region, dirty_region,
+                FIELD_OFFSET(RGNDATA, Buffer[dirty_region->rdh.nRgnSize]));
+
+    InterlockedIncrement(&cs->pending_presents);
 
     cs->ops->submit(cs);
+
+    /* Don't let the application get too far ahead of the command stream
+     * thread, that would only add input latency. */
+    if (cs->pending_presents > WINED3D_CS_MAX_PRESENTS)
+    {
+        LONG tail;
+
+        ++cs->stats.present_stall_count;
+        for (;;)
+        {
+            tail = *(volatile LONG *)&cs->queue.tail;
+            if (*(volatile LONG *)&cs->pending_presents <= WINED3D_CS_MAX_PRESENTS)
+                break;
+            wined3d_cs_wait_retire(cs, tail);
+        }
+    }
+
+    if (cs->thread && TRACE_ON(d3d_perf) && !(++cs->present_count % WINED3D_CS_STATS_FRAMES))
+    {
+        wined3d_cs_dump_stats(cs);
+        memset(&cs->stats, 0, sizeof(cs->stats));
+    }
 }
 
 static void wined3d_cs_exec_clear(struct wined3d_cs *cs, const void *data)
@@ -261,10 +416,10 @@ static void wined3d_cs_exec_clear(struct wined3d_cs *cs, const void *data)
     RECT draw_rect;
 
     device = cs->device;
-    wined3d_get_draw_rect(&device->state, &draw_rect);
+    wined3d_get_draw_rect(&cs->state, &draw_rect);
     device_clear_render_targets(device, device->adapter->gl_info.limits.buffers,
-            &device->fb, op->rect_count, op->rects, &draw_rect, op->flags,
-            op->color, op->depth, op->stencil);
+            &cs->fb, op->rect_count, op->rects, &draw_rect, op->flags,
+            &op->color, op->depth, op->stencil);
 }
 
 void wined3d_cs_emit_clear(struct wined3d_cs *cs, DWORD rect_count, const RECT *rects,
@@ -272,33 +427,55 @@ void wined3d_cs_emit_clear(struct wined3d_cs *cs, DWORD rect_count, const RECT *
 {
     struct wined3d_cs_clear *op;
 
-    op = cs->ops->require_space(cs, sizeof(*op));
+    if (!rects)
+        rect_count = 0;
+
+    op = cs->ops->require_space(cs, FIELD_OFFSET(struct wined3d_cs_clear, rects[max(rect_count, 1)]));
     op->opcode = WINED3D_CS_OP_CLEAR;
-    op->rect_count = rect_count;
-    op->rects = rects;
     op->flags = flags;
-    op->color = color;
+    op->color = *color;
     op->depth = depth;
     op->stencil = stencil;
+    op->rect_count = rect_count;
+    memcpy(op->rects, rects, rect_count * sizeof(*rects));
 
     cs->ops->submit(cs);
 }
 
 static void wined3d_cs_exec_draw(struct wined3d_cs *cs, const void *data)
 {
+    const struct wined3d_gl_info *gl_info = &cs->device->adapter->gl_info;
     const struct wined3d_cs_draw *op = data;
+    struct wined3d_state *state = &cs->state;
+
+    state->base_vertex_index = op->base_vertex_idx;
+    if (!op->indexed)
+    {
+        if (state->load_base_vertex_index)
+        {
+            state->load_base_vertex_index = 0;
+            device_invalidate_state(cs->device, STATE_BASEVERTEXINDEX);
+        }
+    }
+    else if (!gl_info->supported[ARB_DRAW_ELEMENTS_BASE_VERTEX]
+            && state->load_base_vertex_index != op->base_vertex_idx)
+    {
+        state->load_base_vertex_index = op->base_vertex_idx;
+        device_invalidate_state(cs->device, STATE_BASEVERTEXINDEX);
+    }
 
     draw_primitive(cs->device, op->start_idx, op->index_count,
             op->start_instance, op->instance_count, op->indexed);
 }
 
-void wined3d_cs_emit_draw(struct wined3d_cs *cs, UINT start_idx, UINT index_count,
+void wined3d_cs_emit_draw(struct wined3d_cs *cs, INT base_vertex_idx, UINT start_idx, UINT index_count,
         UINT start_instance, UINT instance_count, BOOL indexed)
 {
     struct wined3d_cs_draw *op;
 
     op = cs->ops->require_space(cs, sizeof(*op));
     op->opcode = WINED3D_CS_OP_DRAW;
+    op->base_vertex_idx = base_vertex_idx;
     op->start_idx = start_idx;
     op->index_count = index_count;
     op->start_instance = start_instance;
@@ -312,7 +489,7 @@ static void wined3d_cs_exec_set_viewport(struct wined3d_cs *cs, const void *data
 {
     const struct wined3d_cs_set_viewport *op = data;
 
-    cs->state.viewport = *op->viewport;
+    cs->state.viewport = op->viewport;
     device_invalidate_state(cs->device, STATE_VIEWPORT);
 }
 
@@ -322,7 +499,7 @@ void wined3d_cs_emit_set_viewport(struct wined3d_cs *cs, const struct wined3d_vi
 
     op = cs->ops->require_space(cs, sizeof(*op));
     op->opcode = WINED3D_CS_OP_SET_VIEWPORT;
-    op->viewport = viewport;
+    op->viewport = *viewport;
 
     cs->ops->submit(cs);
 }
@@ -331,7 +508,7 @@ static void wined3d_cs_exec_set_scissor_rect(struct wined3d_cs *cs, const void *
 {
     const struct wined3d_cs_set_scissor_rect *op = data;
 
-    cs->state.scissor_rect = *op->rect;
+    cs->state.scissor_rect = op->rect;
     device_invalidate_state(cs->device, STATE_SCISSORRECT);
 }
 
@@ -341,7 +518,7 @@ void wined3d_cs_emit_set_scissor_rect(struct wined3d_cs *cs, const RECT *rect)
 
     op = cs->ops->require_space(cs, sizeof(*op));
     op->opcode = WINED3D_CS_OP_SET_SCISSOR_RECT;
-    op->rect = rect;
+    op->rect = *rect;
 
     cs->ops->submit(cs);
 }
@@ -763,7 +940,7 @@ static void wined3d_cs_exec_set_transform(struct wined3d_cs *cs, const void *dat
 {
     const struct wined3d_cs_set_transform *op = data;
 
-    cs->state.transforms[op->state] = *op->matrix;
+    cs->state.transforms[op->state] = op->matrix;
     if (op->state < WINED3D_TS_WORLD_MATRIX(cs->device->adapter->gl_info.limits.blends))
         device_invalidate_state(cs->device, STATE_TRANSFORM(op->state));
 }
@@ -776,7 +953,7 @@ void wined3d_cs_emit_set_transform(struct wined3d_cs *cs, enum wined3d_transform
     op = cs->ops->require_space(cs, sizeof(*op));
     op->opcode = WINED3D_CS_OP_SET_TRANSFORM;
     op->state = state;
-    op->matrix = matrix;
+    op->matrix = *matrix;
 
     cs->ops->submit(cs);
 }
@@ -785,7 +962,7 @@ static void wined3d_cs_exec_set_clip_plane(struct wined3d_cs *cs, const void *da
 {
     const struct wined3d_cs_set_clip_plane *op = data;
 
-    cs->state.clip_planes[op->plane_idx] = *op->plane;
+    cs->state.clip_planes[op->plane_idx] = op->plane;
     device_invalidate_state(cs->device, STATE_CLIPPLANE(op->plane_idx));
 }
 
@@ -796,7 +973,7 @@ void wined3d_cs_emit_set_clip_plane(struct wined3d_cs *cs, UINT plane_idx, const
     op = cs->ops->require_space(cs, sizeof(*op));
     op->opcode = WINED3D_CS_OP_SET_CLIP_PLANE;
     op->plane_idx = plane_idx;
-    op->plane = plane;
+    op->plane = *plane;
 
     cs->ops->submit(cs);
 }
@@ -805,7 +982,7 @@ static void wined3d_cs_exec_set_material(struct wined3d_cs *cs, const void *data
 {
     const struct wined3d_cs_set_material *op = data;
 
-    cs->state.material = *op->material;
+    cs->state.material = op->material;
     device_invalidate_state(cs->device, STATE_MATERIAL);
 }
 
@@ -815,7 +992,281 @@ void wined3d_cs_emit_set_material(struct wined3d_cs *cs, const struct wined3d_ma
 
     op = cs->ops->require_space(cs, sizeof(*op));
     op->opcode = WINED3D_CS_OP_SET_MATERIAL;
-    op->material = material;
+    op->material = *material;
+
+    cs->ops->submit(cs);
+}
+
+static void wined3d_cs_exec_set_consts(struct wined3d_cs *cs, const void *data)
+{
+    const struct wined3d_cs_set_consts *op = data;
+    struct wined3d_device *device = cs->device;
+    struct wined3d_state *state = &cs->state;
+
+    switch (op->constant_type)
+    {
+        case WINED3D_SHADER_CONST_VS_F:
+            memcpy(&state->vs_consts_f[op->start_register * 4], op->constants, op->count * sizeof(float) * 4);
+            device->shader_backend->shader_update_float_vertex_constants(device, op->start_register, op->count);
+            break;
+
+        case WINED3D_SHADER_CONST_PS_F:
+            memcpy(&state->ps_consts_f[op->start_register * 4], op->constants, op->count * sizeof(float) * 4);
+            device->shader_backend->shader_update_float_pixel_constants(device, op->start_register, op->count);
+            break;
+
+        case WINED3D_SHADER_CONST_VS_I:
+            memcpy(&state->vs_consts_i[op->start_register * 4], op->constants, op->count * sizeof(int) * 4);
+            device_invalidate_shader_constants(device, op->constant_type);
+            break;
+
+        case WINED3D_SHADER_CONST_PS_I:
+            memcpy(&state->ps_consts_i[op->start_register * 4], op->constants, op->count * sizeof(int) * 4);
+            device_invalidate_shader_constants(device, op->constant_type);
+            break;
+
+        case WINED3D_SHADER_CONST_VS_B:
+            memcpy(&state->vs_consts_b[op->start_register], op->constants, op->count * sizeof(BOOL));
+            device_invalidate_shader_constants(device, op->constant_type);
+            break;
+
+        case WINED3D_SHADER_CONST_PS_B:
+            memcpy(&state->ps_consts_b[op->start_register], op->constants, op->count * sizeof(BOOL));
+            device_invalidate_shader_constants(device, op->constant_type);
+            break;
+
+        default:
+            ERR("Unhandled constant type %#x.\n", op->constant_type);
+            break;
+    }
+}
+
+void wined3d_cs_emit_set_consts(struct wined3d_cs *cs, DWORD constant_type, UINT start_register,
+        const void *constants, UINT count)
+{
+    struct wined3d_cs_set_consts *op;
+    UINT size;
+
+    /* Float and integer constants are 4 component vectors. */
+    size = count;
+    if (!(constant_type & (WINED3D_SHADER_CONST_VS_B | WINED3D_SHADER_CONST_PS_B)))
+        size *= 4;
+
+    op = cs->ops->require_space(cs, FIELD_OFFSET(struct wined3d_cs_set_consts, constants[max(size, 1)]));
+    op->opcode = WINED3D_CS_OP_SET_CONSTS;
+    op->constant_type = constant_type;
+    op->start_register = start_register;
+    op->count = count;
+    memcpy(op->constants, constants, size * sizeof(*op->constants));
+
+    cs->ops->submit(cs);
+}
+
+static struct wined3d_light_info *wined3d_cs_find_light(const struct wined3d_cs *cs, UINT light_idx)
+{
+    struct wined3d_light_info *light_info;
+
+    LIST_FOR_EACH_ENTRY(light_info, &cs->state.light_map[LIGHTMAP_HASHFUNC(light_idx)],
+            struct wined3d_light_info, entry)
+    {
+        if (light_info->OriginalIndex == light_idx)
+            return light_info;
+    }
+
+    return NULL;
+}
+
+static void wined3d_cs_exec_set_light(struct wined3d_cs *cs, const void *data)
+{
+    const struct wined3d_cs_set_light *op = data;
+    struct wined3d_light_info *light_info;
+    UINT light_idx = op->light.OriginalIndex;
+
+    if (!(light_info = wined3d_cs_find_light(cs, light_idx)))
+    {
+        if (!(light_info = HeapAlloc(GetProcessHeap(), HEAP_ZERO_MEMORY, sizeof(*light_info))))
+        {
+            ERR("Failed to allocate light info.\n");
+            return;
+        }
+
+        list_add_head(&cs->state.light_map[LIGHTMAP_HASHFUNC(light_idx)], &light_info->entry);
+        light_info->glIndex = -1;
+        light_info->OriginalIndex = light_idx;
+    }
+
+    if (light_info->glIndex != -1)
+    {
+        if (light_info->OriginalParms.type != op->light.OriginalParms.type)
+            device_invalidate_state(cs->device, STATE_LIGHT_TYPE);
+        device_invalidate_state(cs->device, STATE_ACTIVELIGHT(light_info->glIndex));
+    }
+
+    light_info->OriginalParms = op->light.OriginalParms;
+    memcpy(light_info->lightPosn, op->light.lightPosn, sizeof(light_info->lightPosn));
+    memcpy(light_info->lightDirn, op->light.lightDirn, sizeof(light_info->lightDirn));
+    light_info->exponent = op->light.exponent;
+    light_info->cutoff = op->light.cutoff;
+}
+
+void wined3d_cs_emit_set_light(struct wined3d_cs *cs, const struct wined3d_light_info *light)
+{
+    struct wined3d_cs_set_light *op;
+
+    op = cs->ops->require_space(cs, sizeof(*op));
+    op->opcode = WINED3D_CS_OP_SET_LIGHT;
+    op->light = *light;
+
+    cs->ops->submit(cs);
+}
+
+static void wined3d_cs_exec_set_light_enable(struct wined3d_cs *cs, const void *data)
+{
+    const struct wined3d_gl_info *gl_info = &cs->device->adapter->gl_info;
+    const struct wined3d_cs_set_light_enable *op = data;
+    struct wined3d_light_info *light_info;
+    unsigned int i;
+
+    if (!(light_info = wined3d_cs_find_light(cs, op->light_idx)))
+    {
+        ERR("Light %u is not defined.\n", op->light_idx);
+        return;
+    }
+
+    light_info->enabled = op->enable;
+    if (!op->enable)
+    {
+        if (light_info->glIndex == -1)
+            return;
+
+        device_invalidate_state(cs->device, STATE_LIGHT_TYPE);
+        device_invalidate_state(cs->device, STATE_ACTIVELIGHT(light_info->glIndex));
+        cs->state.lights[light_info->glIndex] = NULL;
+        light_info->glIndex = -1;
+        return;
+    }
+
+    if (light_info->glIndex != -1)
+        return;
+
+    /* Find a free GL light. */
+    for (i = 0; i < gl_info->limits.lights; ++i)
+    {
+        if (!cs->state.lights[i])
+        {
+            cs->state.lights[i] = light_info;
+            light_info->glIndex = i;
+            device_invalidate_state(cs->device, STATE_LIGHT_TYPE);
+            device_invalidate_state(cs->device, STATE_ACTIVELIGHT(i));
+            return;
+        }
+    }
+}
+
+void wined3d_cs_emit_set_light_enable(struct wined3d_cs *cs, UINT light_idx, BOOL enable)
+{
+    struct wined3d_cs_set_light_enable *op;
+
+    op = cs->ops->require_space(cs, sizeof(*op));
+    op->opcode = WINED3D_CS_OP_SET_LIGHT_ENABLE;
+    op->light_idx = light_idx;
+    op->enable = enable;
+
+    cs->ops->submit(cs);
+}
+
+static void wined3d_cs_exec_set_primitive_type(struct wined3d_cs *cs, const void *data)
+{
+    const struct wined3d_cs_set_primitive_type *op = data;
+    GLenum prev;
+
+    prev = cs->state.gl_primitive_type;
+    cs->state.gl_primitive_type = op->gl_primitive_type;
+    if (op->gl_primitive_type != prev && (op->gl_primitive_type == GL_POINTS || prev == GL_POINTS))
+        device_invalidate_state(cs->device, STATE_POINT_SIZE_ENABLE);
+}
+
+void wined3d_cs_emit_set_primitive_type(struct wined3d_cs *cs, GLenum gl_primitive_type)
+{
+    struct wined3d_cs_set_primitive_type *op;
+
+    op = cs->ops->require_space(cs, sizeof(*op));
+    op->opcode = WINED3D_CS_OP_SET_PRIMITIVE_TYPE;
+    op->gl_primitive_type = gl_primitive_type;
+
+    cs->ops->submit(cs);
+}
+
+/* The CS state doesn't hold references, so unlike state_unbind_resources()
+ * this only has to drop the bind counts. */
+static void wined3d_cs_exec_unbind_resources(struct wined3d_cs *cs, const void *data)
+{
+    struct wined3d_state *state = &cs->state;
+    struct wined3d_texture *texture;
+    struct wined3d_buffer *buffer;
+    unsigned int i, j;
+
+    state->vertex_declaration = NULL;
+
+    for (i = 0; i < MAX_COMBINED_SAMPLERS; ++i)
+    {
+        if ((texture = state->textures[i]))
+        {
+            state->textures[i] = NULL;
+            InterlockedDecrement(&texture->resource.bind_count);
+        }
+    }
+
+    for (i = 0; i < MAX_STREAM_OUT; ++i)
+    {
+        if ((buffer = state->stream_output[i].buffer))
+        {
+            state->stream_output[i].buffer = NULL;
+            InterlockedDecrement(&buffer->resource.bind_count);
+        }
+    }
+
+    for (i = 0; i < MAX_STREAMS; ++i)
+    {
+        if ((buffer = state->streams[i].buffer))
+        {
+            state->streams[i].buffer = NULL;
+            InterlockedDecrement(&buffer->resource.bind_count);
+        }
+    }
+
+    if ((buffer = state->index_buffer))
+    {
+        state->index_buffer = NULL;
+        InterlockedDecrement(&buffer->resource.bind_count);
+    }
+
+    for (i = 0; i < WINED3D_SHADER_TYPE_COUNT; ++i)
+    {
+        state->shader[i] = NULL;
+
+        for (j = 0; j < MAX_CONSTANT_BUFFERS; ++j)
+        {
+            if ((buffer = state->cb[i][j]))
+            {
+                state->cb[i][j] = NULL;
+                InterlockedDecrement(&buffer->resource.bind_count);
+            }
+        }
+
+        for (j = 0; j < MAX_SAMPLER_OBJECTS; ++j)
+        {
+            state->sampler[i][j] = NULL;
+        }
+    }
+}
+
+void wined3d_cs_emit_unbind_resources(struct wined3d_cs *cs)
+{
+    struct wined3d_cs_unbind_resources *op;
+
+    op = cs->ops->require_space(cs, sizeof(*op));
+    op->opcode = WINED3D_CS_OP_UNBIND_RESOURCES;
 
     cs->ops->submit(cs);
 }
@@ -842,8 +1293,61 @@ void wined3d_cs_emit_reset_state(struct wined3d_cs *cs)
     cs->ops->submit(cs);
 }
 
+static void wined3d_cs_exec_query_issue(struct wined3d_cs *cs, const void *data)
+{
+    const struct wined3d_cs_query_issue *op = data;
+    struct wined3d_query *query = op->query;
+
+    query->query_ops->query_issue(query, op->flags);
+}
+
+void wined3d_cs_emit_query_issue(struct wined3d_cs *cs, struct wined3d_query *query, DWORD flags)
+{
+    struct wined3d_cs_query_issue *op;
+
+    op = cs->ops->require_space(cs, sizeof(*op));
+    op->opcode = WINED3D_CS_OP_QUERY_ISSUE;
+    op->query = query;
+    op->flags = flags;
+
+    cs->ops->submit(cs);
+}
+
+static void wined3d_cs_exec_query_get_data(struct wined3d_cs *cs, const void *data)
+{
+    const struct wined3d_cs_query_get_data *op = data;
+    struct wined3d_query *query = op->query;
+
+    *op->hr = query->query_ops->query_get_data(query, op->data, op->data_size, op->flags);
+}
+
+/* GL queries live in the context of the thread that issued them, so the
+ * result has to be read back on the command stream thread as well. */
+HRESULT wined3d_cs_emit_query_get_data(struct wined3d_cs *cs, struct wined3d_query *query,
+        void *data, DWORD data_size, DWORD flags)
+{
+    struct wined3d_cs_query_get_data *op;
+    HRESULT hr;
+
+    op = cs->ops->require_space(cs, sizeof(*op));
+    op->opcode = WINED3D_CS_OP_QUERY_GET_DATA;
+    op->query = query;
+    op->data = data;
+    op->data_size = data_size;
+    op->flags = flags;
+    op->hr = &hr;
+
+    cs->ops->submit(cs);
+    cs->ops->finish(cs);
+
+    return hr;
+}
+
 static void (* const wined3d_cs_op_handlers[])(struct wined3d_cs *cs, const void *data) =
 {
+    /* WINED3D_CS_OP_NOP                    */ wined3d_cs_exec_nop,
+    /* WINED3D_CS_OP_SYNC                   */ wined3d_cs_exec_sync,
+    /* WINED3D_CS_OP_STOP                   */ wined3d_cs_exec_nop,
     /* WINED3D_CS_OP_PRESENT                */ wined3d_cs_exec_present,
     /* WINED3D_CS_OP_CLEAR                  */ wined3d_cs_exec_clear,
     /* WINED3D_CS_OP_DRAW                   */ wined3d_cs_exec_draw,
@@ -866,9 +1370,17 @@ static void (* const wined3d_cs_op_handlers[])(struct wined3d_cs *cs, const void
     /* WINED3D_CS_OP_SET_TRANSFORM          */ wined3d_cs_exec_set_transform,
     /* WINED3D_CS_OP_SET_CLIP_PLANE         */ wined3d_cs_exec_set_clip_plane,
     /* WINED3D_CS_OP_SET_MATERIAL           */ wined3d_cs_exec_set_material,
+    /* WINED3D_CS_OP_SET_CONSTS             */ wined3d_cs_exec_set_consts,
+    /* WINED3D_CS_OP_SET_LIGHT              */ wined3d_cs_exec_set_light,
+    /* WINED3D_CS_OP_SET_LIGHT_ENABLE       */ wined3d_cs_exec_set_light_enable,
+    /* WINED3D_CS_OP_SET_PRIMITIVE_TYPE     */ wined3d_cs_exec_set_primitive_type,
+    /* WINED3D_CS_OP_UNBIND_RESOURCES       */ wined3d_cs_exec_unbind_resources,
     /* WINED3D_CS_OP_RESET_STATE            */ wined3d_cs_exec_reset_state,
+    /* WINED3D_CS_OP_QUERY_ISSUE            */ wined3d_cs_exec_query_issue,
+    /* WINED3D_CS_OP_QUERY_GET_DATA         */ wined3d_cs_exec_query_get_data,
 };
 
+
 static void *wined3d_cs_st_require_space(struct wined3d_cs *cs, size_t size)
 {
     if (size > cs->data_size)
@@ -893,12 +1405,236 @@ static void wined3d_cs_st_submit(struct wined3d_cs *cs)
     wined3d_cs_op_handlers[opcode](cs, cs->data);
 }
 
+static void wined3d_cs_st_finish(struct wined3d_cs *cs)
+{
+}
+
 static const struct wined3d_cs_ops wined3d_cs_st_ops =
 {
     wined3d_cs_st_require_space,
     wined3d_cs_st_submit,
+    wined3d_cs_st_finish,
 };
 
+static void wined3d_cs_mt_wake(struct wined3d_cs *cs)
+{
+    if (*(volatile LONG *)&cs->waiting)
+        SetEvent(cs->event);
+}
+
+static size_t wined3d_cs_mt_get_free_space(const struct wined3d_cs *cs, LONG head)
+{
+    /* Leave a gap, "head == tail" means the queue is empty. */
+    return (*(volatile const LONG *)&cs->queue.tail - head - 1) & WINED3D_CS_QUEUE_MASK;
+}
+
+static void wined3d_cs_mt_wait_space(struct wined3d_cs *cs, LONG head, size_t size)
+{
+    if (wined3d_cs_mt_get_free_space(cs, head) >= size)
+        return;
+
+    ++cs->stats.stall_count;
+    for (;;)
+    {
+        LONG tail = *(volatile LONG *)&cs->queue.tail;
+
+        if (wined3d_cs_mt_get_free_space(cs, head) >= size)
+            break;
+        wined3d_cs_mt_wake(cs);
+        wined3d_cs_wait_retire(cs, tail);
+    }
+}
+
+static void wined3d_cs_mt_finish(struct wined3d_cs *cs);
+
+static void *wined3d_cs_mt_require_space(struct wined3d_cs *cs, size_t size)
+{
+    struct wined3d_cs_queue *queue = &cs->queue;
+    struct wined3d_cs_packet *packet;
+    size_t packet_size, remaining;
+    LONG head;
+
+    /* Commands issued by the command stream thread itself, e.g. while
+     * releasing a resource, are executed immediately. */
+    if (cs->thread_id == GetCurrentThreadId())
+        return wined3d_cs_st_require_space(cs, size);
+
+    packet_size = FIELD_OFFSET(struct wined3d_cs_packet, data[size]);
+    packet_size = (packet_size + WINED3D_CS_PACKET_ALIGN - 1) & ~(WINED3D_CS_PACKET_ALIGN - 1);
+    if (packet_size > WINED3D_CS_QUEUE_SIZE / 2)
+    {
+        WARN_(d3d_perf)("Executing %lu byte packet synchronously.\n", (unsigned long)size);
+        wined3d_cs_mt_finish(cs);
+        cs->direct = TRUE;
+        return wined3d_cs_st_require_space(cs, size);
+    }
+
+    head = queue->head;
+    remaining = WINED3D_CS_QUEUE_SIZE - head;
+    if (remaining < packet_size)
+    {
+        /* Pad the end of the queue and wrap around. */
+        wined3d_cs_mt_wait_space(cs, head, remaining);
+        packet = (struct wined3d_cs_packet *)&queue->data[head];
+        packet->size = remaining;
+        *(enum wined3d_cs_op *)packet->data = WINED3D_CS_OP_NOP;
+        head = 0;
+        InterlockedExchange(&queue->head, head);
+    }
+
+    wined3d_cs_mt_wait_space(cs, head, packet_size);
+    packet = (struct wined3d_cs_packet *)&queue->data[head];
+    packet->size = packet_size;
+
+    return packet->data;
+}
+
+static void wined3d_cs_mt_submit(struct wined3d_cs *cs)
+{
+    struct wined3d_cs_queue *queue = &cs->queue;
+    const struct wined3d_cs_packet *packet;
+    unsigned int depth;
+    LONG head;
+
+    if (cs->thread_id == GetCurrentThreadId())
+    {
+        wined3d_cs_st_submit(cs);
+        return;
+    }
+
+    if (cs->direct)
+    {
+        cs->direct = FALSE;
+        wined3d_cs_st_submit(cs);
+        return;
+    }
+
+    head = queue->head;
+    packet = (const struct wined3d_cs_packet *)&queue->data[head];
+    head = (head + packet->size) & WINED3D_CS_QUEUE_MASK;
+    InterlockedExchange(&queue->head, head);
+    cs->idle = FALSE;
+
+    ++cs->stats.packet_count;
+    depth = (head - *(volatile LONG *)&queue->tail) & WINED3D_CS_QUEUE_MASK;
+    if (depth > cs->stats.max_depth)
+        cs->stats.max_depth = depth;
+
+    wined3d_cs_mt_wake(cs);
+}
+
+/* Wait until the command stream thread has executed everything queued so
+ * far. This is needed before the application thread touches anything the
+ * command stream thread may still be using. */
+static void wined3d_cs_mt_finish(struct wined3d_cs *cs)
+{
+    struct wined3d_cs_sync *op;
+
+    if (cs->idle || cs->thread_id == GetCurrentThreadId())
+        return;
+
+    ++cs->stats.finish_count;
+    op = wined3d_cs_mt_require_space(cs, sizeof(*op));
+    op->opcode = WINED3D_CS_OP_SYNC;
+    wined3d_cs_mt_submit(cs);
+
+    WaitForSingleObject(cs->finish_event, INFINITE);
+    cs->idle = TRUE;
+}
+
+static const struct wined3d_cs_ops wined3d_cs_mt_ops =
+{
+    wined3d_cs_mt_require_space,
+    wined3d_cs_mt_submit,
+    wined3d_cs_mt_finish,
+};
+
+static void wined3d_cs_wait_event(struct wined3d_cs *cs, LONG tail)
+{
+    unsigned int i;
+
+    for (i = 0; i < WINED3D_CS_SPIN_COUNT; ++i)
+    {
+        if (*(volatile LONG *)&cs->queue.head != tail)
+            return;
+    }
+
+    InterlockedExchange(&cs->waiting, TRUE);
+    if (*(volatile LONG *)&cs->queue.head == tail)
+        WaitForSingleObject(cs->event, INFINITE);
+    InterlockedExchange(&cs->waiting, FALSE);
+}
+
+static DWORD WINAPI wined3d_cs_run(void *thread_param)
+{
+    struct wined3d_cs *cs = thread_param;
+    struct wined3d_cs_queue *queue = &cs->queue;
+    const struct wined3d_cs_packet *packet;
+    enum wined3d_cs_op opcode;
+    LONG tail;
+
+    TRACE("Started.\n");
+
+    for (;;)
+    {
+        tail = queue->tail;
+        if (*(volatile LONG *)&queue->head == tail)
+        {
+            wined3d_cs_wait_event(cs, tail);
+            continue;
+        }
+
+        packet = (const struct wined3d_cs_packet *)&queue->data[tail];
+        opcode = *(const enum wined3d_cs_op *)packet->data;
+        wined3d_cs_op_handlers[opcode](cs, packet->data);
+        InterlockedExchange(&queue->tail, (tail + packet->size) & WINED3D_CS_QUEUE_MASK);
+        if (*(volatile LONG *)&cs->retire_waiting)
+            SetEvent(cs->retire_event);
+
+        if (opcode == WINED3D_CS_OP_STOP)
+            break;
+    }
+
+    context_set_current(NULL);
+
+    TRACE("Stopped.\n");
+    return 0;
+}
+
+static void wined3d_cs_cleanup_thread(struct wined3d_cs *cs)
+{
+    if (cs->finish_event)
+        CloseHandle(cs->finish_event);
+    if (cs->event)
+        CloseHandle(cs->event);
+    if (cs->retire_event)
+        CloseHandle(cs->retire_event);
+    HeapFree(GetProcessHeap(), 0, cs->queue.data);
+}
+
+static BOOL wined3d_cs_start_thread(struct wined3d_cs *cs)
+{
+    if (!(cs->queue.data = HeapAlloc(GetProcessHeap(), 0, WINED3D_CS_QUEUE_SIZE))
+            || !(cs->event = CreateEventW(NULL, FALSE, FALSE, NULL))
+            || !(cs->finish_event = CreateEventW(NULL, FALSE, FALSE, NULL))
+            || !(cs->retire_event = CreateEventW(NULL, FALSE, FALSE, NULL)))
+    {
+        wined3d_cs_cleanup_thread(cs);
+        return FALSE;
+    }
+
+    cs->idle = TRUE;
+    if (!(cs->thread = CreateThread(NULL, 0, wined3d_cs_run, cs, 0, &cs->thread_id)))
+    {
+        wined3d_cs_cleanup_thread(cs);
+        return FALSE;
+    }
+
+    cs->ops = &wined3d_cs_mt_ops;
+
+    return TRUE;
+}
+
 struct wined3d_cs *wined3d_cs_create(struct wined3d_device *device)
 {
     const struct wined3d_gl_info *gl_info = &device->adapter->gl_info;
@@ -928,17 +1664,108 @@ struct wined3d_cs *wined3d_cs_create(struct wined3d_device *device)
     cs->data_size = WINED3D_INITIAL_CS_SIZE;
     if (!(cs->data = HeapAlloc(GetProcessHeap(), 0, cs->data_size)))
     {
+        state_cleanup(&cs->state);
+        HeapFree(GetProcessHeap(), 0, cs->fb.render_targets);
         HeapFree(GetProcessHeap(), 0, cs);
         return NULL;
     }
 
+    if (wined3d_settings.cs_multithreaded && !wined3d_cs_start_thread(cs))
+        WARN("Failed to start the command stream thread, executing commands on the application thread.\n");
+
     return cs;
 }
 
 void wined3d_cs_destroy(struct wined3d_cs *cs)
 {
+    if (cs->thread)
+    {
+        struct wined3d_cs_stop *op;
+
+        op = cs->ops->require_space(cs, sizeof(*op));
+        op->opcode = WINED3D_CS_OP_STOP;
+        cs->ops->submit(cs);
+
+        WaitForSingleObject(cs->thread, INFINITE);
+        CloseHandle(cs->thread);
+        wined3d_cs_cleanup_thread(cs);
+        cs->ops = &wined3d_cs_st_ops;
+
+        if (TRACE_ON(d3d_perf))
+            wined3d_cs_dump_stats(cs);
+    }
+
     state_cleanup(&cs->state);
     HeapFree(GetProcessHeap(), 0, cs->fb.render_targets);
     HeapFree(GetProcessHeap(), 0, cs->data);
     HeapFree(GetProcessHeap(), 0, cs);
 }
+
+/* The CS state doesn't hold references. Make sure it doesn't keep pointers
+ * to a resource that's being destroyed. The command stream is idle here. */
+void wined3d_cs_resource_released(struct wined3d_cs *cs, struct wined3d_resource *resource)
+{
+    struct wined3d_state *state = &cs->state;
+    unsigned int i, j;
+
+    switch (resource->type)
+    {
+        case WINED3D_RTYPE_SURFACE:
+        {
+            struct wined3d_surface *surface = surface_from_resource(resource);
+
+            for (i = 0; i < cs->device->adapter->gl_info.limits.buffers; ++i)
+            {
+                if (cs->fb.render_targets[i] == surface)
+                    cs->fb.render_targets[i] = NULL;
+            }
+            if (cs->fb.depth_stencil == surface)
+                cs->fb.depth_stencil = NULL;
+            break;
+        }
+
+        case WINED3D_RTYPE_TEXTURE:
+        case WINED3D_RTYPE_CUBE_TEXTURE:
+        case WINED3D_RTYPE_VOLUME_TEXTURE:
+        {
+            struct wined3d_texture *texture = wined3d_texture_from_resource(resource);
+
+            for (i = 0; i < MAX_COMBINED_SAMPLERS; ++i)
+            {
+                if (state->textures[i] == texture)
+                    state->textures[i] = NULL;
+            }
+            break;
+        }
+
+        case WINED3D_RTYPE_BUFFER:
+        {
+            struct wined3d_buffer *buffer = buffer_from_resource(resource);
+
+            for (i = 0; i < MAX_STREAMS; ++i)
+            {
+                if (state->streams[i].buffer == buffer)
+                    state->streams[i].buffer = NULL;
+            }
+            for (i = 0; i < MAX_STREAM_OUT; ++i)
+            {
+                if (state->stream_output[i].buffer == buffer)
+                    state->stream_output[i].buffer = NULL;
+            }
+            if (state->index_buffer == buffer)
+                state->index_buffer = NULL;
+            for (i = 0; i < WINED3D_SHADER_TYPE_COUNT; ++i)
+            {
+                for (j = 0; j < MAX_CONSTANT_BUFFERS; ++j)
+                {
+                    if (state->cb[i][j] == buffer)
+                        state->cb[i][j] = NULL;
+                }
+            }
+            break;
+        }
+
+        default:
+            break;
+    }
+}
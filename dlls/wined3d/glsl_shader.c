@@ -43,6 +43,7 @@
 WINE_DEFAULT_DEBUG_CHANNEL(d3d_shader);
 WINE_DECLARE_DEBUG_CHANNEL(d3d_constants);
 WINE_DECLARE_DEBUG_CHANNEL(d3d);
+WINE_DECLARE_DEBUG_CHANNEL(d3d_perf);
 WINE_DECLARE_DEBUG_CHANNEL(winediag);
 
 #define WINED3D_GLSL_SAMPLE_PROJECTED   0x1
@@ -90,9 +91,36 @@ struct constant_heap
 };
 
 /* GLSL shader private data */
+#define WINED3D_GLSL_PROGRAM_CACHE_MAGIC    0x43533357 /* "W3SC" */
+#define WINED3D_GLSL_PROGRAM_CACHE_VERSION  1
+
+/* On-disk cache of linked program binaries, see ARB_get_program_binary.
+ * Entries are keyed by a hash of the driver identification strings and the
+ * GLSL source of all shader objects attached to the program. */
+struct glsl_program_cache
+{
+    BOOL enabled;
+    BOOL driver_hash_valid;
+    ULONGLONG driver_hash;
+    unsigned int hit_count;
+    unsigned int miss_count;
+    unsigned int store_count;
+    unsigned int reject_count;
+};
+
+struct glsl_program_cache_header
+{
+    DWORD magic;
+    DWORD version;
+    ULONGLONG key;
+    GLenum format;
+    DWORD size;
+};
+
 struct shader_glsl_priv {
     struct wined3d_shader_buffer shader_buffer;
     struct wine_rb_tree program_lookup;
+    struct glsl_program_cache program_cache;
     struct constant_heap vconst_heap;
     struct constant_heap pconst_heap;
     unsigned char *stack;
@@ -410,6 +438,246 @@ static void shader_glsl_validate_link(const struct wined3d_gl_info *gl_info, GLh
     print_glsl_info_log(gl_info, program);
 }
 
+/* 64-bit FNV-1a. */
+static ULONGLONG shader_glsl_hash_data(ULONGLONG hash, const void *data, SIZE_T size)
+{
+    const BYTE *ptr = data;
+
+    while (size--)
+    {
+        hash ^= *ptr++;
+        hash *= ((ULONGLONG)0x100 << 32) | 0x1b3;
+    }
+
+    return hash;
+}
+
+static ULONGLONG shader_glsl_hash_string(ULONGLONG hash, const char *str)
+{
+    return shader_glsl_hash_data(hash, str ? str : "", str ? strlen(str) + 1 : 1);
+}
+
+static void shader_glsl_program_cache_init(struct glsl_program_cache *cache, const struct wined3d_gl_info *gl_info)
+{
+    if (!wined3d_settings.shader_cache)
+        return;
+
+    if (!gl_info->supported[ARB_GET_PROGRAM_BINARY])
+    {
+        WARN("ARB_get_program_binary not supported, not using the shader cache.\n");
+        return;
+    }
+
+    if (!CreateDirectoryA(wined3d_settings.shader_cache, NULL) && GetLastError() != ERROR_ALREADY_EXISTS)
+    {
+        WARN("Failed to create shader cache directory %s, last error %#x.\n",
+                debugstr_a(wined3d_settings.shader_cache), GetLastError());
+        return;
+    }
+
+    cache->enabled = TRUE;
+}
+
+static void shader_glsl_program_cache_cleanup(const struct glsl_program_cache *cache)
+{
+    if (!cache->enabled)
+        return;
+
+    TRACE_(d3d_perf)("Program cache: %u hits, %u misses, %u stores, %u rejected entries.\n",
+            cache->hit_count, cache->miss_count, cache->store_count, cache->reject_count);
+}
+
+static BOOL shader_glsl_program_cache_get_path(ULONGLONG key, char *path, SIZE_T size)
+{
+    int len = snprintf(path, size, "%s\\%08x%08x.bin", wined3d_settings.shader_cache,
+            (unsigned int)(key >> 32), (unsigned int)key);
+
+    if (len < 0 || len >= size)
+    {
+        WARN("Shader cache path %s is too long, not using the cache.\n",
+                debugstr_a(wined3d_settings.shader_cache));
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/* Context activation is done by the caller. */
+static BOOL shader_glsl_program_cache_get_key(const struct wined3d_gl_info *gl_info,
+        struct glsl_program_cache *cache, GLhandleARB program, const struct wined3d_shader *gshader,
+        ULONGLONG *key)
+{
+    GLint i, object_count, source_size = 0;
+    ULONGLONG hash, source_hash = 0;
+    GLhandleARB *objects;
+    char *source = NULL;
+
+    if (!cache->driver_hash_valid)
+    {
+        hash = ((ULONGLONG)0xcbf29ce4 << 32) | 0x84222325;
+        hash = shader_glsl_hash_string(hash, (const char *)gl_info->gl_ops.gl.p_glGetString(GL_VENDOR));
+        hash = shader_glsl_hash_string(hash, (const char *)gl_info->gl_ops.gl.p_glGetString(GL_RENDERER));
+        hash = shader_glsl_hash_string(hash, (const char *)gl_info->gl_ops.gl.p_glGetString(GL_VERSION));
+        cache->driver_hash = hash;
+        cache->driver_hash_valid = TRUE;
+    }
+
+    GL_EXTCALL(glGetObjectParameterivARB(program, GL_OBJECT_ATTACHED_OBJECTS_ARB, &object_count));
+    if (!(objects = HeapAlloc(GetProcessHeap(), 0, object_count * sizeof(*objects))))
+        return FALSE;
+    GL_EXTCALL(glGetAttachedObjectsARB(program, object_count, NULL, objects));
+
+    /* The attachment order isn't guaranteed to be stable, so combine the
+     * per-object hashes in an order independent way. */
+    for (i = 0; i < object_count; ++i)
+    {
+        GLint length;
+
+        GL_EXTCALL(glGetObjectParameterivARB(objects[i], GL_OBJECT_SHADER_SOURCE_LENGTH_ARB, &length));
+        if (source_size < length)
+        {
+            HeapFree(GetProcessHeap(), 0, source);
+            if (!(source = HeapAlloc(GetProcessHeap(), 0, length)))
+            {
+                HeapFree(GetProcessHeap(), 0, objects);
+                return FALSE;
+            }
+            source_size = length;
+        }
+
+        GL_EXTCALL(glGetShaderSourceARB(objects[i], source_size, &length, source));
+        source_hash += shader_glsl_hash_data(cache->driver_hash, source, length);
+    }
+
+    HeapFree(GetProcessHeap(), 0, source);
+    HeapFree(GetProcessHeap(), 0, objects);
+
+    hash = shader_glsl_hash_data(cache->driver_hash, &source_hash, sizeof(source_hash));
+    if (gshader)
+    {
+        DWORD gs_params[3];
+
+        gs_params[0] = gshader->u.gs.input_type;
+        gs_params[1] = gshader->u.gs.output_type;
+        gs_params[2] = gshader->u.gs.vertices_out;
+        hash = shader_glsl_hash_data(hash, gs_params, sizeof(gs_params));
+    }
+    *key = hash;
+
+    return TRUE;
+}
+
+/* Context activation is done by the caller. */
+static BOOL shader_glsl_program_cache_load(const struct wined3d_gl_info *gl_info,
+        struct glsl_program_cache *cache, GLhandleARB program, ULONGLONG key)
+{
+    struct glsl_program_cache_header header;
+    char path[MAX_PATH];
+    void *data = NULL;
+    GLint link_status;
+    HANDLE file;
+    DWORD read;
+    BOOL ret;
+
+    if (!shader_glsl_program_cache_get_path(key, path, sizeof(path)))
+        return FALSE;
+    file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, 0, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        ++cache->miss_count;
+        return FALSE;
+    }
+
+    ret = ReadFile(file, &header, sizeof(header), &read, NULL) && read == sizeof(header)
+            && header.magic == WINED3D_GLSL_PROGRAM_CACHE_MAGIC
+            && header.version == WINED3D_GLSL_PROGRAM_CACHE_VERSION
+            && header.key == key
+            && (data = HeapAlloc(GetProcessHeap(), 0, header.size))
+            && ReadFile(file, data, header.size, &read, NULL) && read == header.size;
+    CloseHandle(file);
+
+    if (ret)
+    {
+        GL_EXTCALL(glProgramBinary(program, header.format, data, header.size));
+        GL_EXTCALL(glGetObjectParameterivARB(program, GL_OBJECT_LINK_STATUS_ARB, &link_status));
+        /* The driver may reject binaries from a different driver build. */
+        ret = !!link_status;
+    }
+    HeapFree(GetProcessHeap(), 0, data);
+
+    if (!ret)
+    {
+        TRACE("Rejecting cached binary for program %u.\n", program);
+        ++cache->reject_count;
+        DeleteFileA(path);
+        return FALSE;
+    }
+
+    TRACE("Loaded program %u from the shader cache.\n", program);
+    ++cache->hit_count;
+    return TRUE;
+}
+
+/* Context activation is done by the caller. */
+static void shader_glsl_program_cache_store(const struct wined3d_gl_info *gl_info,
+        struct glsl_program_cache *cache, GLhandleARB program, ULONGLONG key)
+{
+    struct glsl_program_cache_header header;
+    char path[MAX_PATH], tmp_path[MAX_PATH];
+    GLint link_status, size;
+    DWORD written;
+    HANDLE file;
+    void *data;
+    BOOL ret;
+    int len;
+
+    /* Write to a temporary file first, so that other processes never see a
+     * partially written entry. */
+    if (!shader_glsl_program_cache_get_path(key, path, sizeof(path)))
+        return;
+    len = snprintf(tmp_path, sizeof(tmp_path), "%s.%x", path, GetCurrentProcessId());
+    if (len < 0 || len >= sizeof(tmp_path))
+    {
+        WARN("Temporary path for %s is too long, not storing the program.\n", debugstr_a(path));
+        return;
+    }
+
+    GL_EXTCALL(glGetObjectParameterivARB(program, GL_OBJECT_LINK_STATUS_ARB, &link_status));
+    if (!link_status)
+        return;
+
+    GL_EXTCALL(glGetObjectParameterivARB(program, GL_PROGRAM_BINARY_LENGTH, &size));
+    if (size <= 0 || !(data = HeapAlloc(GetProcessHeap(), 0, size)))
+        return;
+
+    header.magic = WINED3D_GLSL_PROGRAM_CACHE_MAGIC;
+    header.version = WINED3D_GLSL_PROGRAM_CACHE_VERSION;
+    header.key = key;
+    GL_EXTCALL(glGetProgramBinary(program, size, &size, &header.format, data));
+    checkGLcall("glGetProgramBinary");
+    header.size = size;
+
+    file = CreateFileA(tmp_path, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, 0, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        HeapFree(GetProcessHeap(), 0, data);
+        return;
+    }
+
+    ret = WriteFile(file, &header, sizeof(header), &written, NULL) && written == sizeof(header)
+            && WriteFile(file, data, header.size, &written, NULL) && written == header.size;
+    CloseHandle(file);
+    HeapFree(GetProcessHeap(), 0, data);
+
+    if (!ret || !MoveFileExA(tmp_path, path, MOVEFILE_REPLACE_EXISTING))
+    {
+        WARN("Failed to write shader cache entry %s.\n", debugstr_a(path));
+        DeleteFileA(tmp_path);
+        return;
+    }
+
+    ++cache->store_count;
+}
+
 /* Context activation is done by the caller. */
 static void shader_glsl_load_psamplers(const struct wined3d_gl_info *gl_info,
         const DWORD *tex_unit_map, GLhandleARB programId)
@@ -979,10 +1247,10 @@ static void shader_generate_glsl_declarations(const struct wined3d_context *cont
         const struct wined3d_shader_reg_maps *reg_maps, const struct shader_glsl_ctx_priv *ctx_priv)
 {
     const struct wined3d_shader_version *version = &reg_maps->shader_version;
-    const struct wined3d_state *state = &shader->device->state;
+    const struct wined3d_state *state = &shader->device->cs->state;
     const struct ps_compile_args *ps_args = ctx_priv->cur_ps_args;
     const struct wined3d_gl_info *gl_info = context->gl_info;
-    const struct wined3d_fb_state *fb = &shader->device->fb;
+    const struct wined3d_fb_state *fb = &shader->device->cs->fb;
     unsigned int i, extra_constants_needed = 0;
     const struct wined3d_shader_lconst *lconst;
     const char *prefix;
@@ -5772,6 +6040,7 @@ static void set_glsl_shader_program(const struct wined3d_context *context, const
     GLhandleARB gs_id = 0;
     GLhandleARB ps_id = 0;
     struct list *ps_list, *vs_list;
+    ULONGLONG cache_key;
 
     if (!(context->shader_update_mask & (1 << WINED3D_SHADER_TYPE_VERTEX)))
     {
@@ -5939,10 +6208,22 @@ static void set_glsl_shader_program(const struct wined3d_context *context, const
         list_add_head(ps_list, &entry->ps.shader_entry);
     }
 
-    /* Link the program */
-    TRACE("Linking GLSL shader program %u\n", programId);
-    GL_EXTCALL(glLinkProgramARB(programId));
-    shader_glsl_validate_link(gl_info, programId);
+    if (!priv->program_cache.enabled || !shader_glsl_program_cache_get_key(gl_info,
+            &priv->program_cache, programId, gshader, &cache_key))
+    {
+        /* Link the program */
+        TRACE("Linking GLSL shader program %u\n", programId);
+        GL_EXTCALL(glLinkProgramARB(programId));
+        shader_glsl_validate_link(gl_info, programId);
+    }
+    else if (!shader_glsl_program_cache_load(gl_info, &priv->program_cache, programId, cache_key))
+    {
+        TRACE("Linking GLSL shader program %u\n", programId);
+        GL_EXTCALL(glProgramParameteri(programId, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE));
+        GL_EXTCALL(glLinkProgramARB(programId));
+        shader_glsl_validate_link(gl_info, programId);
+        shader_glsl_program_cache_store(gl_info, &priv->program_cache, programId, cache_key);
+    }
 
     shader_glsl_init_vs_uniform_locations(gl_info, programId, &entry->vs,
             vshader ? vshader->limits.constant_float : 0);
@@ -6501,6 +6782,7 @@ static HRESULT shader_glsl_alloc(struct wined3d_device *device, const struct win
     priv->fragment_pipe = fragment_pipe;
     fragment_pipe->get_caps(gl_info, &fragment_caps);
     priv->ffp_proj_control = fragment_caps.wined3d_caps & WINED3D_FRAGMENT_CAP_PROJ_CONTROL;
+    shader_glsl_program_cache_init(&priv->program_cache, gl_info);
 
     device->vertex_priv = vertex_priv;
     device->fragment_priv = fragment_priv;
@@ -6538,6 +6820,7 @@ static void shader_glsl_free(struct wined3d_device *device)
         }
     }
 
+    shader_glsl_program_cache_cleanup(&priv->program_cache);
     wine_rb_destroy(&priv->program_lookup, NULL, NULL);
     constant_heap_free(&priv->pconst_heap);
     constant_heap_free(&priv->vconst_heap);
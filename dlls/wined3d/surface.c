@@ -2944,6 +2944,8 @@ HRESULT CDECL wined3d_surface_unmap(struct wined3d_surface *surface)
         WARN("Trying to unmap unmapped surface.\n");
         return WINEDDERR_NOTLOCKED;
     }
+
+    surface->resource.device->cs->ops->finish(surface->resource.device->cs);
     --surface->resource.map_count;
 
     surface->surface_ops->surface_unmap(surface);
@@ -2963,6 +2965,8 @@ HRESULT CDECL wined3d_surface_map(struct wined3d_surface *surface,
     TRACE("surface %p, map_desc %p, rect %s, flags %#x.\n",
             surface, map_desc, wine_dbgstr_rect(rect), flags);
 
+    device->cs->ops->finish(device->cs);
+
     if (surface->resource.map_count)
     {
         WARN("Surface is already mapped.\n");
@@ -3098,6 +3102,8 @@ HRESULT CDECL wined3d_surface_getdc(struct wined3d_surface *surface, HDC *dc)
     if (surface->flags & SFLAG_DCINUSE)
         return WINEDDERR_DCALREADYCREATED;
 
+    surface->resource.device->cs->ops->finish(surface->resource.device->cs);
+
     /* Can't GetDC if the surface is locked. */
     if (surface->resource.map_count)
         return WINED3DERR_INVALIDCALL;
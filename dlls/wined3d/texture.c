@@ -570,6 +570,8 @@ DWORD CDECL wined3d_texture_set_lod(struct wined3d_texture *texture, DWORD lod)
         return 0;
     }
 
+    texture->resource.device->cs->ops->finish(texture->resource.device->cs);
+
     if (lod >= texture->level_count)
         lod = texture->level_count - 1;
 
@@ -637,6 +637,8 @@ HRESULT CDECL wined3d_volume_map(struct wined3d_volume *volume,
     TRACE("volume %p, map_desc %p, box %p, flags %#x.\n",
             volume, map_desc, box, flags);
 
+    device->cs->ops->finish(device->cs);
+
     map_desc->data = NULL;
     if (!(volume->resource.access_flags & WINED3D_RESOURCE_ACCESS_CPU))
     {
@@ -788,6 +790,8 @@ HRESULT CDECL wined3d_volume_unmap(struct wined3d_volume *volume)
         return WINED3DERR_INVALIDCALL;
     }
 
+    volume->resource.device->cs->ops->finish(volume->resource.device->cs);
+
     if (volume->flags & WINED3D_VFLAG_PBO)
     {
         struct wined3d_device *device = volume->resource.device;
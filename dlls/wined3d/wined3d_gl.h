@@ -57,6 +57,7 @@ enum wined3d_gl_extension
     ARB_FRAMEBUFFER_OBJECT,
     ARB_FRAMEBUFFER_SRGB,
     ARB_GEOMETRY_SHADER4,
+    ARB_GET_PROGRAM_BINARY,
     ARB_HALF_FLOAT_PIXEL,
     ARB_HALF_FLOAT_VERTEX,
     ARB_INSTANCED_ARRAYS,
@@ -228,6 +229,10 @@ enum wined3d_gl_extension
     USE_GL_FUNC(glFramebufferTextureFaceARB) \
     USE_GL_FUNC(glFramebufferTextureLayerARB) \
     USE_GL_FUNC(glProgramParameteriARB) \
+    /* GL_ARB_get_program_binary */ \
+    USE_GL_FUNC(glGetProgramBinary) \
+    USE_GL_FUNC(glProgramBinary) \
+    USE_GL_FUNC(glProgramParameteri) \
     /* GL_ARB_instanced_arrays */ \
     USE_GL_FUNC(glVertexAttribDivisorARB) \
     /* GL_ARB_internalformat_query */ \
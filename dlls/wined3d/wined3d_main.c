@@ -85,6 +85,8 @@ struct wined3d_settings wined3d_settings =
     ~0U,            /* No GS shader model limit by default. */
     ~0U,            /* No PS shader model limit by default. */
     FALSE,          /* 3D support enabled by default. */
+    FALSE,          /* Command stream runs on the application thread. */
+    NULL,           /* No on-disk shader cache by default. */
 };
 
 struct wined3d * CDECL wined3d_create(DWORD flags)
@@ -272,6 +274,15 @@ static BOOL wined3d_dll_init(HINSTANCE hInstDLL)
             if (!wined3d_settings.logo) ERR("Failed to allocate logo path memory.\n");
             else memcpy(wined3d_settings.logo, buffer, len);
         }
+        if (!get_config_key(hkey, appkey, "ShaderCache", buffer, size))
+        {
+            size_t len = strlen(buffer) + 1;
+
+            TRACE("Using shader cache directory %s.\n", debugstr_a(buffer));
+            wined3d_settings.shader_cache = HeapAlloc(GetProcessHeap(), 0, len);
+            if (!wined3d_settings.shader_cache) ERR("Failed to allocate shader cache path memory.\n");
+            else memcpy(wined3d_settings.shader_cache, buffer, len);
+        }
         if ( !get_config_key( hkey, appkey, "Multisampling", buffer, size) )
         {
             if (!strcmp(buffer, "disabled"))
@@ -304,6 +315,12 @@ static BOOL wined3d_dll_init(HINSTANCE hInstDLL)
             TRACE("Disabling 3D support.\n");
             wined3d_settings.no_3d = TRUE;
         }
+        if (!get_config_key(hkey, appkey, "CSMT", buffer, size)
+                && !strcmp(buffer, "enabled"))
+        {
+            TRACE("Enabling the multithreaded command stream.\n");
+            wined3d_settings.cs_multithreaded = TRUE;
+        }
     }
 
     if (appkey) RegCloseKey( appkey );
@@ -336,6 +353,7 @@ static BOOL wined3d_dll_destroy(HINSTANCE hInstDLL)
     HeapFree(GetProcessHeap(), 0, wndproc_table.entries);
 
     HeapFree(GetProcessHeap(), 0, wined3d_settings.logo);
+    HeapFree(GetProcessHeap(), 0, wined3d_settings.shader_cache);
     UnregisterClassA(WINED3D_OPENGL_WINDOW_CLASS_NAME, hInstDLL);
 
     DeleteCriticalSection(&wined3d_wndproc_cs);
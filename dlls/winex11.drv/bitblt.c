@@ -1568,6 +1568,9 @@ struct x11drv_window_surface
     COLORREF              color_key;
     HRGN                  region;
     void                 *bits;
+    BYTE                 *shadow;       /* copy of the bits last sent to the server */
+    BOOL                  shadow_valid; /* whether the server contents match the shadow copy */
+    RECT                  exposed;      /* area to send even if it matches the shadow copy */
 #ifdef HAVE_LIBXXSHM
     XShmSegmentInfo       shminfo;
 #endif
@@ -1862,6 +1865,7 @@ static void x11drv_surface_set_region( struct window_surface *window_surface, HR
     TRACE( "updating surface %p with %p\n", surface, region );
 
     window_surface->funcs->lock( window_surface );
+    surface->shadow_valid = FALSE;  /* parts that weren't visible so far may need to be sent */
     if (!region)
     {
         if (surface->region) DeleteObject( surface->region );
@@ -1882,15 +1886,166 @@ static void x11drv_surface_set_region( struct window_surface *window_surface, HR
     window_surface->funcs->unlock( window_surface );
 }
 
+/* surfaces are flushed in tiles of this size once they are large enough */
+#define SURFACE_TILE_SIZE 32
+
+static inline BOOL use_surface_tiles( const struct x11drv_window_surface *surface )
+{
+    return (surface->header.rect.right - surface->header.rect.left > 2 * SURFACE_TILE_SIZE &&
+            surface->header.rect.bottom - surface->header.rect.top > 2 * SURFACE_TILE_SIZE);
+}
+
+/***********************************************************************
+ *           convert_surface_rows
+ *
+ * Copy the rows of the surface bits to the image if it uses separate bits.
+ */
+static void convert_surface_rows( struct x11drv_window_surface *surface, int top, int bottom )
+{
+    unsigned char *src = surface->bits;
+    unsigned char *dst = (unsigned char *)surface->image->data;
+    const int *mapping = NULL;
+    int width_bytes = surface->image->bytes_per_line;
+
+    if (src == dst) return;
+
+    if (surface->image->bits_per_pixel == 4 || surface->image->bits_per_pixel == 8)
+        mapping = X11DRV_PALETTE_PaletteToXPixel;
+
+    src += top * width_bytes;
+    dst += top * width_bytes;
+    copy_image_byteswap( &surface->info, src, dst, width_bytes, width_bytes,
+                         bottom - top, surface->byteswap, mapping, ~0u );
+}
+
+/***********************************************************************
+ *           put_surface_image
+ *
+ * Send a rectangle of the surface image to the server.
+ */
+static UINT put_surface_image( struct x11drv_window_surface *surface, const RECT *rect )
+{
+#ifdef HAVE_LIBXXSHM
+    if (surface->shminfo.shmid != -1)
+        XShmPutImage( gdi_display, surface->window, surface->gc, surface->image,
+                      rect->left, rect->top,
+                      surface->header.rect.left + rect->left,
+                      surface->header.rect.top + rect->top,
+                      rect->right - rect->left, rect->bottom - rect->top, False );
+    else
+#endif
+    XPutImage( gdi_display, surface->window, surface->gc, surface->image,
+               rect->left, rect->top,
+               surface->header.rect.left + rect->left,
+               surface->header.rect.top + rect->top,
+               rect->right - rect->left, rect->bottom - rect->top );
+
+    return (rect->bottom - rect->top) *
+           (((rect->right - rect->left) * surface->image->bits_per_pixel + 7) / 8);
+}
+
+/***********************************************************************
+ *           get_row_bytes
+ *
+ * Byte range of the pixels between left and right in a row of the surface.
+ */
+static inline void get_row_bytes( const struct x11drv_window_surface *surface, int left, int right,
+                                  int *start, int *end )
+{
+    int bpp = surface->info.bmiHeader.biBitCount;
+
+    *start = left * bpp / 8;
+    *end   = (right * bpp + 7) / 8;
+}
+
+/***********************************************************************
+ *           is_tile_modified
+ *
+ * Check whether a tile of the surface differs from the shadow copy.
+ */
+static BOOL is_tile_modified( const struct x11drv_window_surface *surface, const RECT *rect )
+{
+    int y, start, end, stride = surface->image->bytes_per_line;
+    const BYTE *bits = (const BYTE *)surface->bits + rect->top * stride;
+    const BYTE *shadow = surface->shadow + rect->top * stride;
+
+    get_row_bytes( surface, rect->left, rect->right, &start, &end );
+    for (y = rect->top; y < rect->bottom; y++, bits += stride, shadow += stride)
+        if (memcmp( bits + start, shadow + start, end - start )) return TRUE;
+    return FALSE;
+}
+
+/***********************************************************************
+ *           flush_tile_run
+ *
+ * Update the shadow copy for a run of modified tiles and send it to the server.
+ */
+static UINT flush_tile_run( struct x11drv_window_surface *surface, const RECT *rect )
+{
+    int y, start, end, stride = surface->image->bytes_per_line;
+    const BYTE *bits = (const BYTE *)surface->bits + rect->top * stride;
+    BYTE *shadow = surface->shadow + rect->top * stride;
+
+    get_row_bytes( surface, rect->left, rect->right, &start, &end );
+    for (y = rect->top; y < rect->bottom; y++, bits += stride, shadow += stride)
+        memcpy( shadow + start, bits + start, end - start );
+    return put_surface_image( surface, rect );
+}
+
+/***********************************************************************
+ *           flush_modified_tiles
+ *
+ * Send only the tiles within the bounds that changed since the last flush. Everything
+ * outside of the bounds is unchanged, so the shadow copy only needs to be compared there.
+ */
+static UINT flush_modified_tiles( struct x11drv_window_surface *surface, const RECT *bounds )
+{
+    RECT band, tile, run, tmp;
+    BOOL converted;
+    UINT bytes = 0;
+    int x, y;
+
+    for (y = bounds->top & ~(SURFACE_TILE_SIZE - 1); y < bounds->bottom; y += SURFACE_TILE_SIZE)
+    {
+        band.top    = max( y, bounds->top );
+        band.bottom = min( y + SURFACE_TILE_SIZE, bounds->bottom );
+        converted   = FALSE;
+        SetRectEmpty( &run );
+
+        for (x = bounds->left & ~(SURFACE_TILE_SIZE - 1); x < bounds->right; x += SURFACE_TILE_SIZE)
+        {
+            tile.left   = max( x, bounds->left );
+            tile.right  = min( x + SURFACE_TILE_SIZE, bounds->right );
+            tile.top    = band.top;
+            tile.bottom = band.bottom;
+
+            if (IntersectRect( &tmp, &tile, &surface->exposed ) || is_tile_modified( surface, &tile ))
+            {
+                if (IsRectEmpty( &run )) run = tile;
+                else run.right = tile.right;
+                continue;
+            }
+            if (IsRectEmpty( &run )) continue;
+            if (!converted) convert_surface_rows( surface, band.top, band.bottom );
+            converted = TRUE;
+            bytes += flush_tile_run( surface, &run );
+            SetRectEmpty( &run );
+        }
+        if (IsRectEmpty( &run )) continue;
+        if (!converted) convert_surface_rows( surface, band.top, band.bottom );
+        bytes += flush_tile_run( surface, &run );
+    }
+    return bytes;
+}
+
 /***********************************************************************
  *           x11drv_surface_flush
  */
 static void x11drv_surface_flush( struct window_surface *window_surface )
 {
     struct x11drv_window_surface *surface = get_x11_surface( window_surface );
-    unsigned char *src = surface->bits;
-    unsigned char *dst = (unsigned char *)surface->image->data;
     struct bitblt_coords coords;
+    UINT bytes;
 
     window_surface->funcs->lock( window_surface );
     coords.x = 0;
@@ -1906,39 +2061,29 @@ static void x11drv_surface_flush( struct window_surface *window_surface )
 
         if (surface->is_argb || surface->color_key != CLR_INVALID) update_surface_region( surface );
 
-        if (src != dst)
-        {
-            const int *mapping = NULL;
-            int width_bytes = surface->image->bytes_per_line;
-
-            if (surface->image->bits_per_pixel == 4 || surface->image->bits_per_pixel == 8)
-                mapping = X11DRV_PALETTE_PaletteToXPixel;
+        if (use_surface_tiles( surface ) && !surface->shadow)
+            surface->shadow = HeapAlloc( GetProcessHeap(), 0, surface->info.bmiHeader.biSizeImage );
 
-            src += coords.visrect.top * width_bytes;
-            dst += coords.visrect.top * width_bytes;
-            copy_image_byteswap( &surface->info, src, dst, width_bytes, width_bytes,
-                                 coords.visrect.bottom - coords.visrect.top,
-                                 surface->byteswap, mapping, ~0u );
+        if (surface->shadow && surface->shadow_valid)
+        {
+            bytes = flush_modified_tiles( surface, &coords.visrect );
         }
-
-#ifdef HAVE_LIBXXSHM
-        if (surface->shminfo.shmid != -1)
-            XShmPutImage( gdi_display, surface->window, surface->gc, surface->image,
-                          coords.visrect.left, coords.visrect.top,
-                          surface->header.rect.left + coords.visrect.left,
-                          surface->header.rect.top + coords.visrect.top,
-                          coords.visrect.right - coords.visrect.left,
-                          coords.visrect.bottom - coords.visrect.top, False );
         else
-#endif
-        XPutImage( gdi_display, surface->window, surface->gc, surface->image,
-                   coords.visrect.left, coords.visrect.top,
-                   surface->header.rect.left + coords.visrect.left,
-                   surface->header.rect.top + coords.visrect.top,
-                   coords.visrect.right - coords.visrect.left,
-                   coords.visrect.bottom - coords.visrect.top );
+        {
+            if (surface->shadow)
+            {
+                /* the server contents are unknown, start over with the whole surface */
+                SetRect( &coords.visrect, 0, 0, coords.width, coords.height );
+                memcpy( surface->shadow, surface->bits, surface->info.bmiHeader.biSizeImage );
+                surface->shadow_valid = TRUE;
+            }
+            convert_surface_rows( surface, coords.visrect.top, coords.visrect.bottom );
+            bytes = put_surface_image( surface, &coords.visrect );
+        }
+        TRACE( "%p: sent %u bytes\n", surface, bytes );
     }
     reset_bounds( &surface->bounds );
+    SetRectEmpty( &surface->exposed );
     window_surface->funcs->unlock( window_surface );
 }
 
@@ -1966,6 +2111,7 @@ static void x11drv_surface_destroy( struct window_surface *window_surface )
         surface->image->data = NULL;
         XDestroyImage( surface->image );
     }
+    HeapFree( GetProcessHeap(), 0, surface->shadow );
     surface->crit.DebugInfo->Spare[0] = 0;
     DeleteCriticalSection( &surface->crit );
     if (surface->region) DeleteObject( surface->region );
@@ -2081,6 +2227,7 @@ HRGN expose_surface( struct window_surface *window_surface, const RECT *rect )
 
     window_surface->funcs->lock( window_surface );
     add_bounds_rect( &surface->bounds, rect );
+    UnionRect( &surface->exposed, &surface->exposed, rect );
     if (surface->region)
     {
         region = CreateRectRgnIndirect( rect );
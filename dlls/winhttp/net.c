@@ -289,6 +289,21 @@ BOOL netconn_connected( netconn_t *conn )
     return (conn->socket != -1);
 }
 
+/* check that an idle connection hasn't been closed by the server */
+BOOL netconn_is_alive( netconn_t *conn )
+{
+#ifdef MSG_DONTWAIT
+    ssize_t len;
+    BYTE b;
+
+    len = recv( conn->socket, &b, 1, MSG_PEEK | MSG_DONTWAIT );
+    return len == 1 || (len == -1 && errno == EWOULDBLOCK);
+#else
+    FIXME("not supported on this platform\n");
+    return TRUE;
+#endif
+}
+
 BOOL netconn_create( netconn_t *conn, int domain, int type, int protocol )
 {
     if ((conn->socket = socket( domain, type, protocol )) == -1)
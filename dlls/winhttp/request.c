@@ -179,18 +179,55 @@ static const WCHAR *attribute_table[] =
 
 static DWORD CALLBACK task_thread( LPVOID param )
 {
-    task_header_t *task = param;
+    request_t *request = param;
+    task_header_t *task;
+    struct list *entry;
 
-    task->proc( task );
+    for (;;)
+    {
+        EnterCriticalSection( &request->task_cs );
+        if (!(entry = list_head( &request->task_queue )))
+        {
+            request->task_running = FALSE;
+            LeaveCriticalSection( &request->task_cs );
+            break;
+        }
+        list_remove( entry );
+        LeaveCriticalSection( &request->task_cs );
 
-    release_object( &task->request->hdr );
-    heap_free( task );
+        task = LIST_ENTRY( entry, task_header_t, entry );
+        task->proc( task );
+
+        release_object( &task->request->hdr );
+        heap_free( task );
+    }
+    /* the worker's own reference keeps the request alive while it drains the queue */
+    release_object( &request->hdr );
     return ERROR_SUCCESS;
 }
 
+/* Tasks for a request are run in order by a single worker at a time, so a
+ * request never ties up more than one thread however many calls are pending.
+ * The caller must hold a reference on the request for the task. */
 static BOOL queue_task( task_header_t *task )
 {
-    return QueueUserWorkItem( task_thread, task, WT_EXECUTELONGFUNCTION );
+    request_t *request = task->request;
+    BOOL ret = TRUE;
+
+    EnterCriticalSection( &request->task_cs );
+    list_add_tail( &request->task_queue, &task->entry );
+    if (!request->task_running)
+    {
+        addref_object( &request->hdr );
+        if ((ret = QueueUserWorkItem( task_thread, request, WT_EXECUTELONGFUNCTION )))
+            request->task_running = TRUE;
+        else
+            list_remove( &task->entry );
+    }
+    LeaveCriticalSection( &request->task_cs );
+
+    if (!ret) release_object( &request->hdr );
+    return ret;
 }
 
 static void free_header( header_t *header )
@@ -936,6 +973,138 @@ static WCHAR *addr_to_str( const struct sockaddr *addr )
     return strdupAW( buf );
 }
 
+#define MAX_POOLED_CONNECTIONS  16
+#define KEEP_ALIVE_TIMEOUT      30000
+
+typedef struct
+{
+    struct list entry;
+    WCHAR *hostname;
+    WCHAR *servername;
+    INTERNET_PORT hostport;
+    INTERNET_PORT serverport;
+    netconn_t netconn;
+    ULONGLONG keep_until;
+} pooled_conn_t;
+
+static void free_pooled_conn( pooled_conn_t *conn, BOOL close )
+{
+    if (close) netconn_close( &conn->netconn );
+    heap_free( conn->hostname );
+    heap_free( conn->servername );
+    heap_free( conn );
+}
+
+static BOOL match_pooled_conn( const pooled_conn_t *conn, request_t *request, INTERNET_PORT port )
+{
+    connect_t *connect = request->connect;
+    BOOL secure = (request->hdr.flags & WINHTTP_FLAG_SECURE) != 0;
+
+    return conn->serverport == port && conn->hostport == connect->hostport &&
+           conn->netconn.secure == secure &&
+           conn->netconn.security_flags == request->netconn.security_flags &&
+           !strcmpiW( conn->servername, connect->servername ) &&
+           !strcmpiW( conn->hostname, connect->hostname );
+}
+
+/* take an idle connection to the same server out of the session's pool */
+static BOOL get_pooled_connection( request_t *request, INTERNET_PORT port )
+{
+    session_t *session = request->connect->session;
+    pooled_conn_t *conn, *next, *found;
+    ULONGLONG now = GetTickCount64();
+
+    for (;;)
+    {
+        found = NULL;
+
+        EnterCriticalSection( &session->cs );
+        LIST_FOR_EACH_ENTRY_SAFE( conn, next, &session->conn_pool, pooled_conn_t, entry )
+        {
+            if (conn->keep_until < now)
+            {
+                list_remove( &conn->entry );
+                free_pooled_conn( conn, TRUE );
+            }
+            else if (!found && match_pooled_conn( conn, request, port ))
+            {
+                list_remove( &conn->entry );
+                found = conn;
+            }
+        }
+        LeaveCriticalSection( &session->cs );
+
+        if (!found) return FALSE;
+        if (netconn_is_alive( &found->netconn )) break;
+
+        TRACE("pooled connection %p was closed by the server\n", found);
+        free_pooled_conn( found, TRUE );
+    }
+
+    TRACE("reusing pooled connection %p\n", found);
+    request->netconn = found->netconn;
+    free_pooled_conn( found, FALSE );
+
+    netconn_set_timeout( &request->netconn, TRUE, request->send_timeout );
+    netconn_set_timeout( &request->netconn, FALSE, request->recv_timeout );
+    return TRUE;
+}
+
+/* called when the request handle goes away, keep the connection around for
+ * other requests to the same server if the response was read completely */
+void release_connection( request_t *request )
+{
+    session_t *session = request->connect->session;
+    connect_t *connect = request->connect;
+    pooled_conn_t *conn;
+
+    if (!netconn_connected( &request->netconn )) return;
+
+    if (!request->conn_idle || request->read_size ||
+        !(conn = heap_alloc_zero( sizeof(*conn) )))
+    {
+        close_connection( request );
+        return;
+    }
+    conn->hostname   = strdupW( connect->hostname );
+    conn->servername = strdupW( connect->servername );
+    if (!conn->hostname || !conn->servername)
+    {
+        close_connection( request );
+        free_pooled_conn( conn, FALSE );
+        return;
+    }
+    conn->hostport   = connect->hostport;
+    conn->serverport = connect->serverport ? connect->serverport :
+                       (request->hdr.flags & WINHTTP_FLAG_SECURE ? 443 : 80);
+    conn->netconn    = request->netconn;
+    conn->keep_until = GetTickCount64() + KEEP_ALIVE_TIMEOUT;
+    netconn_init( &request->netconn );
+
+    TRACE("pooling connection %p\n", conn);
+
+    EnterCriticalSection( &session->cs );
+    if (list_count( &session->conn_pool ) >= MAX_POOLED_CONNECTIONS)
+    {
+        pooled_conn_t *oldest = LIST_ENTRY( list_tail( &session->conn_pool ), pooled_conn_t, entry );
+        list_remove( &oldest->entry );
+        free_pooled_conn( oldest, TRUE );
+    }
+    list_add_head( &session->conn_pool, &conn->entry );
+    LeaveCriticalSection( &session->cs );
+}
+
+void free_connection_pool( session_t *session )
+{
+    pooled_conn_t *conn, *next;
+
+    LIST_FOR_EACH_ENTRY_SAFE( conn, next, &session->conn_pool, pooled_conn_t, entry )
+    {
+        list_remove( &conn->entry );
+        free_pooled_conn( conn, TRUE );
+    }
+}
+
 static BOOL open_connection( request_t *request )
 {
     connect_t *connect;
@@ -952,6 +1121,8 @@ static BOOL open_connection( request_t *request )
     saddr = (struct sockaddr *)&connect->sockaddr;
     slen = sizeof(struct sockaddr);
 
+    if (get_pooled_connection( request, port )) goto done;
+
     if (!connect->resolved)
     {
         len = strlenW( connect->servername ) + 1;
@@ -1004,6 +1175,7 @@ static BOOL open_connection( request_t *request )
     send_callback( &request->hdr, WINHTTP_CALLBACK_STATUS_CONNECTED_TO_SERVER, addressW, strlenW(addressW) + 1 );
 
 done:
+    request->conn_idle = FALSE;
     request->read_pos = request->read_size = 0;
     request->read_chunked = FALSE;
     request->read_chunked_size = ~0u;
@@ -2106,6 +2278,7 @@ static void finished_reading( request_t *request )
     }
     else if (!strcmpW( request->version, http1_0 )) close = TRUE;
     if (close) close_connection( request );
+    else request->conn_idle = TRUE;
 }
 
 static BOOL read_data( request_t *request, void *buffer, DWORD size, DWORD *read, BOOL async )
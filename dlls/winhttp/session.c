@@ -105,6 +105,9 @@ static void session_destroy( object_header_t *hdr )
     heap_free( session->proxy_bypass );
     heap_free( session->proxy_username );
     heap_free( session->proxy_password );
+    free_connection_pool( session );
+    session->cs.DebugInfo->Spare[0] = 0;
+    DeleteCriticalSection( &session->cs );
     heap_free( session );
 }
 
@@ -233,6 +236,9 @@ HINTERNET WINAPI WinHttpOpen( LPCWSTR agent, DWORD access, LPCWSTR proxy, LPCWST
     session->send_timeout = DEFAULT_SEND_TIMEOUT;
     session->recv_timeout = DEFAULT_RECEIVE_TIMEOUT;
     list_init( &session->cookie_cache );
+    list_init( &session->conn_pool );
+    InitializeCriticalSection( &session->cs );
+    session->cs.DebugInfo->Spare[0] = (DWORD_PTR)(__FILE__ ": session.cs");
 
     if (agent && !(session->agent = strdupW( agent ))) goto end;
     if (access == WINHTTP_ACCESS_TYPE_DEFAULT_PROXY)
@@ -558,6 +564,9 @@ static void request_destroy( object_header_t *hdr )
 
     release_object( &request->connect->hdr );
 
+    request->task_cs.DebugInfo->Spare[0] = 0;
+    DeleteCriticalSection( &request->task_cs );
+
     destroy_authinfo( request->authinfo );
     destroy_authinfo( request->proxy_authinfo );
 
@@ -1057,6 +1066,9 @@ HINTERNET WINAPI WinHttpOpenRequest( HINTERNET hconnect, LPCWSTR verb, LPCWSTR o
     request->hdr.context = connect->hdr.context;
     request->hdr.redirect_policy = connect->hdr.redirect_policy;
     list_init( &request->hdr.children );
+    list_init( &request->task_queue );
+    InitializeCriticalSection( &request->task_cs );
+    request->task_cs.DebugInfo->Spare[0] = (DWORD_PTR)(__FILE__ ": request.task_cs");
 
     addref_object( &connect->hdr );
     request->connect = connect;
@@ -1769,6 +1769,14 @@ static const char okmsg[] =
 "Server: winetest\r\n"
 "\r\n";
 
+static const char keepalive_page[] = "keepalive";
+
+static const char keepalivemsg[] =
+"HTTP/1.1 200 OK\r\n"
+"Server: winetest\r\n"
+"Content-Length: 9\r\n"
+"\r\n";
+
 static const char noauthmsg[] =
 "HTTP/1.1 401 Unauthorized\r\n"
 "Server: winetest\r\n"
@@ -1821,9 +1829,10 @@ static DWORD CALLBACK server_thread(LPVOID param)
 
     listen(s, 0);
     SetEvent(si->event);
+    c = -1;
     do
     {
-        c = accept(s, NULL, NULL);
+        if (c == -1) c = accept(s, NULL, NULL);
 
         memset(buffer, 0, sizeof buffer);
         for(i = 0; i < sizeof buffer - 1; i++)
@@ -1859,6 +1868,12 @@ static DWORD CALLBACK server_thread(LPVOID param)
         {
             send(c, page1, sizeof page1 - 1, 0);
         }
+        if (strstr(buffer, "GET /keepalive"))
+        {
+            send(c, keepalivemsg, sizeof keepalivemsg - 1, 0);
+            send(c, keepalive_page, sizeof keepalive_page - 1, 0);
+            continue; /* wait for the next request on this connection */
+        }
         if (strstr(buffer, "GET /quit"))
         {
             send(c, okmsg, sizeof okmsg - 1, 0);
@@ -1867,6 +1882,7 @@ static DWORD CALLBACK server_thread(LPVOID param)
         }
         shutdown(c, 2);
         closesocket(c);
+        c = -1;
 
     } while (!last_request);
 
@@ -2241,6 +2257,116 @@ static void test_connection_info( int port )
     WinHttpCloseHandle( ses );
 }
 
+static DWORD connected_count;
+
+static void CALLBACK count_connections( HINTERNET handle, DWORD_PTR context, DWORD status, LPVOID buffer, DWORD buflen )
+{
+    if (status == WINHTTP_CALLBACK_STATUS_CONNECTED_TO_SERVER) connected_count++;
+}
+
+static void test_connection_reuse( int port )
+{
+    static const WCHAR keepaliveW[] = {'/','k','e','e','p','a','l','i','v','e',0};
+    HINTERNET ses, con, req;
+    char buffer[0x100];
+    DWORD count, i;
+    BOOL ret;
+
+    ses = WinHttpOpen( test_useragent, 0, NULL, NULL, 0 );
+    ok( ses != NULL, "failed to open session %u\n", GetLastError() );
+
+    WinHttpSetStatusCallback( ses, count_connections, WINHTTP_CALLBACK_FLAG_ALL_NOTIFICATIONS, 0 );
+
+    con = WinHttpConnect( ses, localhostW, port, 0 );
+    ok( con != NULL, "failed to open a connection %u\n", GetLastError() );
+
+    connected_count = 0;
+    for (i = 0; i < 2; i++)
+    {
+        req = WinHttpOpenRequest( con, NULL, keepaliveW, NULL, NULL, NULL, 0 );
+        ok( req != NULL, "failed to open a request %u\n", GetLastError() );
+
+        ret = WinHttpSendRequest( req, NULL, 0, NULL, 0, 0, 0 );
+        ok( ret, "failed to send request %u\n", GetLastError() );
+
+        ret = WinHttpReceiveResponse( req, NULL );
+        ok( ret, "failed to receive response %u\n", GetLastError() );
+
+        count = 0;
+        memset( buffer, 0, sizeof(buffer) );
+        ret = WinHttpReadData( req, buffer, sizeof(buffer), &count );
+        ok( ret, "failed to read data %u\n", GetLastError() );
+        ok( count == sizeof keepalive_page - 1, "got %u\n", count );
+        ok( !memcmp( buffer, keepalive_page, sizeof keepalive_page ), "wrong data\n" );
+
+        WinHttpCloseHandle( req );
+    }
+    /* the second request picks up the connection left behind by the first */
+    ok( connected_count == 1, "expected 1 connection, got %u\n", connected_count );
+
+    WinHttpCloseHandle( con );
+    WinHttpCloseHandle( ses );
+}
+
+static HANDLE close_event;
+static HINTERNET close_request;
+
+static void CALLBACK close_callback( HINTERNET handle, DWORD_PTR context, DWORD status, LPVOID buffer, DWORD buflen )
+{
+    if (handle != close_request) return;
+    switch (status)
+    {
+    case WINHTTP_CALLBACK_STATUS_SENDREQUEST_COMPLETE:
+    case WINHTTP_CALLBACK_STATUS_REQUEST_ERROR:
+        SetEvent( close_event );
+        break;
+    case WINHTTP_CALLBACK_STATUS_HEADERS_AVAILABLE:
+        /* close the request from inside the completion callback */
+        WinHttpCloseHandle( handle );
+        break;
+    case WINHTTP_CALLBACK_STATUS_HANDLE_CLOSING:
+        SetEvent( close_event );
+        break;
+    }
+}
+
+static void test_close_from_callback( int port )
+{
+    static const WCHAR basicW[] = {'/','b','a','s','i','c',0};
+    HINTERNET ses, con;
+    DWORD ret;
+
+    close_event = CreateEventW( NULL, FALSE, FALSE, NULL );
+
+    ses = WinHttpOpen( test_useragent, 0, NULL, NULL, WINHTTP_FLAG_ASYNC );
+    ok( ses != NULL, "failed to open session %u\n", GetLastError() );
+
+    WinHttpSetStatusCallback( ses, close_callback, WINHTTP_CALLBACK_FLAG_ALL_NOTIFICATIONS, 0 );
+
+    con = WinHttpConnect( ses, localhostW, port, 0 );
+    ok( con != NULL, "failed to open a connection %u\n", GetLastError() );
+
+    close_request = WinHttpOpenRequest( con, NULL, basicW, NULL, NULL, NULL, 0 );
+    ok( close_request != NULL, "failed to open a request %u\n", GetLastError() );
+
+    ret = WinHttpSendRequest( close_request, NULL, 0, NULL, 0, 0, 0 );
+    ok( ret, "failed to send request %u\n", GetLastError() );
+
+    ret = WaitForSingleObject( close_event, 5000 );
+    ok( ret == WAIT_OBJECT_0, "send request did not complete\n" );
+
+    ret = WinHttpReceiveResponse( close_request, NULL );
+    ok( ret, "failed to receive response %u\n", GetLastError() );
+
+    ret = WaitForSingleObject( close_event, 5000 );
+    ok( ret == WAIT_OBJECT_0, "request handle was not closed\n" );
+
+    close_request = NULL;
+    WinHttpCloseHandle( con );
+    WinHttpCloseHandle( ses );
+    CloseHandle( close_event );
+}
+
 static void test_credentials(void)
 {
     static WCHAR userW[] = {'u','s','e','r',0};
@@ -3090,6 +3216,8 @@ START_TEST (winhttp)
     test_basic_authentication(si.port);
     test_bad_header(si.port);
     test_multiple_reads(si.port);
+    test_close_from_callback(si.port);
+    test_connection_reuse(si.port);
 
     /* send the basic request again to shutdown the server thread */
     test_basic_request(si.port, NULL, quitW);
@@ -110,6 +110,8 @@ typedef struct
     LPWSTR proxy_username;
     LPWSTR proxy_password;
     struct list cookie_cache;
+    CRITICAL_SECTION cs;
+    struct list conn_pool; /* idle keep-alive connections */
 } session_t;
 
 typedef struct
@@ -201,12 +203,17 @@ typedef struct
     DWORD num_accept_types;
     struct authinfo *authinfo;
     struct authinfo *proxy_authinfo;
+    BOOL conn_idle;       /* response fully read, connection can be reused */
+    CRITICAL_SECTION task_cs;
+    struct list task_queue;
+    BOOL task_running;    /* a worker is draining task_queue */
 } request_t;
 
 typedef struct _task_header_t task_header_t;
 
 struct _task_header_t
 {
+    struct list entry;
     request_t *request;
     void (*proc)( task_header_t * );
 };
@@ -259,12 +266,15 @@ void set_last_error( DWORD ) DECLSPEC_HIDDEN;
 DWORD get_last_error( void ) DECLSPEC_HIDDEN;
 void send_callback( object_header_t *, DWORD, LPVOID, DWORD ) DECLSPEC_HIDDEN;
 void close_connection( request_t * ) DECLSPEC_HIDDEN;
+void release_connection( request_t * ) DECLSPEC_HIDDEN;
+void free_connection_pool( session_t * ) DECLSPEC_HIDDEN;
 
 BOOL netconn_close( netconn_t * ) DECLSPEC_HIDDEN;
 BOOL netconn_connect( netconn_t *, const struct sockaddr *, unsigned int, int ) DECLSPEC_HIDDEN;
 BOOL netconn_connected( netconn_t * ) DECLSPEC_HIDDEN;
 BOOL netconn_create( netconn_t *, int, int, int ) DECLSPEC_HIDDEN;
 BOOL netconn_init( netconn_t * ) DECLSPEC_HIDDEN;
+BOOL netconn_is_alive( netconn_t * ) DECLSPEC_HIDDEN;
 void netconn_unload( void ) DECLSPEC_HIDDEN;
 ULONG netconn_query_data_available( netconn_t * ) DECLSPEC_HIDDEN;
 BOOL netconn_recv( netconn_t *, void *, size_t, int, int * ) DECLSPEC_HIDDEN;
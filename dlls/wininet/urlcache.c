@@ -292,14 +292,29 @@ static inline void urlcache_block_alloc(BYTE *allocation_table, DWORD block_numb
  */
 static DWORD urlcache_entry_alloc(urlcache_header *header, DWORD blocks_needed, entry_header **entry)
 {
-    DWORD block, block_size;
+    DWORD block, block_size, cur;
 
     for(block=0; block<header->capacity_in_blocks; block+=block_size+1)
     {
+        /* skip over fully allocated bytes of the table */
+        while(!(block%CHAR_BIT) && block+CHAR_BIT<=header->capacity_in_blocks
+                && header->allocation_table[block/CHAR_BIT] == 0xff)
+            block += CHAR_BIT;
+
         block_size = 0;
-        while(block_size<blocks_needed && block_size+block<header->capacity_in_blocks
-                && urlcache_block_is_free(header->allocation_table, block+block_size))
-            block_size++;
+        while(block_size<blocks_needed && block_size+block<header->capacity_in_blocks)
+        {
+            cur = block+block_size;
+            /* count fully free bytes at once */
+            if(!(cur%CHAR_BIT) && blocks_needed-block_size>=CHAR_BIT
+                    && cur+CHAR_BIT<=header->capacity_in_blocks
+                    && !header->allocation_table[cur/CHAR_BIT])
+                block_size += CHAR_BIT;
+            else if(urlcache_block_is_free(header->allocation_table, cur))
+                block_size++;
+            else
+                break;
+        }
 
         if(block_size == blocks_needed)
         {
@@ -4691,6 +4691,15 @@ typedef struct _QUOTA_LIMITS_EX {
 #define FILE_NAMED_STREAMS              0x00040000
 #define FILE_READ_ONLY_VOLUME           0x00080000
 
+#define COMPRESSION_FORMAT_NONE         0x0000
+#define COMPRESSION_FORMAT_DEFAULT      0x0001
+#define COMPRESSION_FORMAT_LZNT1        0x0002
+#define COMPRESSION_FORMAT_XPRESS       0x0003
+#define COMPRESSION_FORMAT_XPRESS_HUFF  0x0004
+#define COMPRESSION_ENGINE_STANDARD     0x0000
+#define COMPRESSION_ENGINE_MAXIMUM      0x0100
+#define COMPRESSION_ENGINE_HIBER        0x0200
+
 /* File alignments (NT) */
 #define	FILE_BYTE_ALIGNMENT		0x00000000
 #define	FILE_WORD_ALIGNMENT		0x00000001